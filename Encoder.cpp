@@ -5,6 +5,8 @@
 // configure options with #define (before they include it), and
 // to facilitate some crafty optimizations!
 
-Encoder_internal_state_t * Encoder::interruptArgs[];
+// Even the interruptArgs tables are now in the header, as static members
+// of the EncoderDispatch template (utility/interrupt_dispatch.h), so every
+// BasicEncoder configuration gets its own.
 
 
@@ -33,6 +33,8 @@
 #include "Arduino.h"
 #elif defined(WIRING)
 #include "Wiring.h"
+#elif defined(__linux__)
+#include "utility/linux_gpio.h"
 #else
 #include "WProgram.h"
 #include "pins_arduino.h"
@@ -42,11 +44,32 @@
 
 #if defined(ENCODER_USE_INTERRUPTS) || !defined(ENCODER_DO_NOT_USE_INTERRUPTS)
 #define ENCODER_USE_INTERRUPTS
-#define ENCODER_ARGLIST_SIZE CORE_NUM_INTERRUPT
 #include "utility/interrupt_pins.h"
 #ifdef ENCODER_OPTIMIZE_INTERRUPTS
 #include "utility/interrupt_config.h"
 #endif
+// ENCODER_INTERRUPT_SLOTS sizes the interrupt tables for the number of
+// interrupt pins actually used, rather than every interrupt the board
+// has.  See utility/interrupt_dispatch.h.
+#if defined(ENCODER_INTERRUPT_SLOTS) && defined(ENCODER_OPTIMIZE_INTERRUPTS)
+#error "ENCODER_INTERRUPT_SLOTS can not be used with ENCODER_OPTIMIZE_INTERRUPTS"
+#endif
+// Cores with attachInterruptArg() pass the encoder's state straight to
+// the interrupt routine, so no table or per-pin routine is needed.
+// Define ENCODER_NO_ATTACH_ARG to use the tables anyway.
+#if (defined(ESP32) || defined(ESP8266)) && !defined(ENCODER_NO_ATTACH_ARG) \
+  && !defined(ENCODER_OPTIMIZE_INTERRUPTS)
+#define ENCODER_ATTACH_ARG
+#endif
+#if defined(ENCODER_ATTACH_ARG)
+#undef ENCODER_INTERRUPT_SLOTS
+#define ENCODER_ARGLIST_SIZE 0
+#elif defined(ENCODER_INTERRUPT_SLOTS) && !defined(ENCODER_LINUX_GPIO)
+#define ENCODER_ARGLIST_SIZE ENCODER_INTERRUPT_SLOTS
+#else
+#undef ENCODER_INTERRUPT_SLOTS	// Linux dispatches by line number
+#define ENCODER_ARGLIST_SIZE CORE_NUM_INTERRUPT
+#endif
 #else
 #define ENCODER_ARGLIST_SIZE 0
 #endif
@@ -58,28 +81,390 @@
 #define ENCODER_ISR_ATTR
 #endif
 
+// Disable interrupts, returning the previous setting for
+// encoder_irq_restore(), for code which may run either in an interrupt
+// or from loop().  interrupts() would turn them on inside an interrupt.
+#if defined(ENCODER_LINUX_GPIO)
+typedef uint8_t encoder_irq_t;
+static inline encoder_irq_t encoder_irq_disable() { noInterrupts(); return 1; }
+static inline void encoder_irq_restore(encoder_irq_t s) { interrupts(); }
+#elif defined(__AVR__)
+typedef uint8_t encoder_irq_t;
+static inline encoder_irq_t encoder_irq_disable() { uint8_t s = SREG; cli(); return s; }
+static inline void encoder_irq_restore(encoder_irq_t s) { SREG = s; }
+#elif defined(__arm__)
+typedef uint32_t encoder_irq_t;
+static inline encoder_irq_t encoder_irq_disable() {
+	uint32_t s;
+	asm volatile("mrs %0, primask\n\tcpsid i" : "=r" (s) : : "memory");
+	return s;
+}
+static inline void encoder_irq_restore(encoder_irq_t s) {
+	asm volatile("msr primask, %0" : : "r" (s) : "memory");
+}
+#elif defined(ESP8266)
+typedef uint32_t encoder_irq_t;
+static inline encoder_irq_t encoder_irq_disable() { return xt_rsil(15); }
+static inline void encoder_irq_restore(encoder_irq_t s) { xt_wsr_ps(s); }
+#elif defined(ESP32)
+typedef UBaseType_t encoder_irq_t;
+static inline encoder_irq_t encoder_irq_disable() { return portSET_INTERRUPT_MASK_FROM_ISR(); }
+static inline void encoder_irq_restore(encoder_irq_t s) { portCLEAR_INTERRUPT_MASK_FROM_ISR(s); }
+#else
+// unknown CPU, not safe inside interrupts
+typedef uint8_t encoder_irq_t;
+static inline encoder_irq_t encoder_irq_disable() { noInterrupts(); return 1; }
+static inline void encoder_irq_restore(encoder_irq_t s) { interrupts(); }
+#endif
+
+// Time for a passive R-C filter to charge through the pullup resistors,
+// before the initial state is read.  0 if the pins have no capacitors.
+#ifndef ENCODER_SETTLE_MICROSECONDS
+#define ENCODER_SETTLE_MICROSECONDS	2000
+#endif
+
+// Interrupt strategy, one of these for Traits::interrupts
+#define ENCODER_POLLED		0	// never use interrupts, update when read
+#define ENCODER_INTERRUPTS	1	// use interrupts on capable pins
+
+// Filter, one of these for Traits::filter
+#define ENCODER_FILTER_NONE	0	// impossible 2 step changes assume pin1 edges
+#define ENCODER_FILTER_REJECT	1	// impossible 2 step changes are ignored
+
+// Decode modes, for begin() when Traits::pulse_modes is true
+#define ENCODER_QUADRATURE	0	// A/B quadrature, the normal mode
+#define ENCODER_STEP_DIR	1	// pin1 step, pin2 direction (high = +1)
+#define ENCODER_UP_DOWN		2	// pin1 counts up, pin2 counts down (CW/CCW)
+
+// Per-instance configuration.  The old #define switches set the defaults
+// used by plain Encoder.  To give one encoder different settings, derive
+// from EncoderDefaultTraits, override what you need, and use BasicEncoder:
+//
+//   struct SlowKnob : EncoderDefaultTraits {
+//     static const uint8_t interrupts = ENCODER_POLLED;
+//     typedef int16_t count_t;
+//   };
+//   BasicEncoder<SlowKnob> knob(7, 8);
+//
+// Everything is resolved at compile time, so each BasicEncoder type only
+// contains the code for its own features.  With ENCODER_OPTIMIZE_INTERRUPTS
+// the interrupt vectors belong to plain Encoder, so other BasicEncoder
+// types must use ENCODER_POLLED.
+//
+// The price is per type, not per encoder: every traits type with
+// interrupts has its own interruptArgs table, 1 pointer per board
+// interrupt (CORE_NUM_INTERRUPT, 2 on Uno, 6 on Mega, 54 on Due),
+// and its own isrN routine for each of those pins.  A table can not be
+// shared, because the routines call each type's own update() directly,
+// with no function pointer.  So a sketch mixing 3 traits types on a Mega
+// uses 3 tables of 12 bytes and 18 small routines.  Where that matters,
+// ENCODER_INTERRUPT_SLOTS shrinks each table to the pins really used,
+// and ESP32 / ESP8266 need no table at all.  See
+// utility/interrupt_dispatch.h.
+struct EncoderDefaultTraits {
+#ifdef ENCODER_USE_INTERRUPTS
+	static const uint8_t interrupts = ENCODER_INTERRUPTS;
+#else
+	static const uint8_t interrupts = ENCODER_POLLED;
+#endif
+	typedef int32_t count_t;		// int16_t or int32_t
+#ifdef ENCODER_TRACK_MOTION
+	static const bool track_motion = true;	// record edge times, see EncoderMonitor.h
+#else
+	static const bool track_motion = false;
+#endif
+	static const uint8_t filter = ENCODER_FILTER_NONE;
+#ifdef ENCODER_POSITION_COMPARE
+	static const bool compare = true;	// compare targets, see setCompareTargets()
+#else
+	static const bool compare = false;
+#endif
+#ifdef ENCODER_PULSE_MODES
+	static const bool pulse_modes = true;	// step/dir and up/down, see begin()
+#else
+	static const bool pulse_modes = false;
+#endif
+#ifdef ENCODER_HISTORY
+	static const bool history = true;	// time & position ring, see EncoderHistory.h
+#else
+	static const bool history = false;
+#endif
+#ifdef ENCODER_RETRANSMIT
+	static const bool retransmit = true;	// quadrature output, see setRetransmit()
+#else
+	static const bool retransmit = false;
+#endif
+#ifdef ENCODER_NOTIFY
+	static const bool notify = true;	// function called every count, see onCount()
+#else
+	static const bool notify = false;
+#endif
+#ifdef ENCODER_MOVEMENT
+	static const bool movement = true;	// counts never written, see movement()
+#else
+	static const bool movement = false;
+#endif
+};
+
+struct EncoderPolledTraits : EncoderDefaultTraits {
+	static const uint8_t interrupts = ENCODER_POLLED;
+};
+
+// Optional per-edge timing, kept by update() for track_motion
+typedef struct {
+	uint32_t               last_edge;	// micros() of most recent count
+	uint32_t               interval;	// micros() between last 2 counts
+	int8_t                 direction;	// +1 or -1, most recent count
+	uint16_t               reversals;	// increments on direction change
+} Encoder_motion_t;
+
+// Optional ring of (time, position), written by update() for history.
+// Entries are in time order, the newest at head - 1.
+typedef struct {
+	uint32_t               time;		// micros()
+	int32_t                position;
+} Encoder_history_entry_t;
+
+typedef struct {
+	Encoder_history_entry_t * entries;
+	uint16_t               mask;		// size - 1, size is a power of 2
+	volatile uint16_t      head;		// total recorded, wraps around
+	volatile uint16_t      used;		// valid entries, up to size
+} Encoder_history_t;
+
+static inline void encoder_history_record(Encoder_history_t *h, uint32_t time, int32_t position)
+{
+	Encoder_history_entry_t *e = h->entries + (h->head & h->mask);
+	e->time = time;
+	e->position = position;
+	h->head = h->head + 1;
+	if (h->used <= h->mask) h->used = h->used + 1;
+}
+
+// Compare output actions, for setCompareOutput()
+#define ENCODER_OUTPUT_TOGGLE	0
+#define ENCODER_OUTPUT_HIGH	1
+#define ENCODER_OUTPUT_LOW	2
+
 // All the data needed by interrupts is consolidated into this ugly struct
 // to facilitate assembly language optimizing of the speed critical update.
 // The assembly code uses auto-incrementing addressing modes, so the struct
 // must remain in exactly this order.
-typedef struct {
+template <typename count_t>
+struct Encoder_core_state {
 	volatile IO_REG_TYPE * pin1_register;
 	volatile IO_REG_TYPE * pin2_register;
 	IO_REG_TYPE            pin1_bitmask;
 	IO_REG_TYPE            pin2_bitmask;
 	uint8_t                state;
-	int32_t                position;
-} Encoder_internal_state_t;
+	count_t                position;
+};
+
+// Optional parts, empty unless enabled by the traits
+template <bool enable>
+struct Encoder_motion_state { };
+
+template <>
+struct Encoder_motion_state<true> {
+	Encoder_motion_t       motion;
+};
+
+template <typename count_t, bool enable>
+struct Encoder_compare_state { };
+
+template <typename count_t>
+struct Encoder_compare_state<count_t, true> {
+	count_t                next_up;		// only these 2 are tested on
+	count_t                next_down;	// every count
+	const count_t *        targets;		// sorted, lowest first
+	uint8_t                count;
+	uint8_t                index;		// targets[index] is next_up
+	uint8_t                output_action;
+	volatile IO_REG_TYPE * output_register;
+	IO_REG_TYPE            output_bitmask;
+	void                   (*function)(count_t target, int8_t direction);
+};
+
+template <bool enable>
+struct Encoder_history_state { };
+
+template <>
+struct Encoder_history_state<true> {
+	Encoder_history_t *    history;		// 0 until setHistory()
+};
+
+template <bool enable>
+struct Encoder_retransmit_state { };
+
+template <>
+struct Encoder_retransmit_state<true> {
+	volatile IO_REG_TYPE * out_a_register;	// 0 until setRetransmit()
+	volatile IO_REG_TYPE * out_b_register;
+	IO_REG_TYPE            out_a_bitmask;
+	IO_REG_TYPE            out_b_bitmask;
+	uint16_t               multiply;	// output = input * multiply / divide
+	uint16_t               divide;
+	uint16_t               remainder;	// 0 to divide - 1
+	uint8_t                phase;		// output A,B: 0=00 1=01 2=11 3=10
+	bool                   invert;
+};
+
+template <typename count_t, bool enable>
+struct Encoder_notify_state { };
+
+template <typename count_t>
+struct Encoder_notify_state<count_t, true> {
+	void                   (*notify)(void *context, count_t position);
+	void *                 notify_context;
+};
+
+template <typename count_t, bool enable>
+struct Encoder_movement_state { };
+
+template <typename count_t>
+struct Encoder_movement_state<count_t, true> {
+	count_t                movement;	// only changed by counting
+};
+
+template <bool enable>
+struct Encoder_mode_state { };
+
+template <>
+struct Encoder_mode_state<true> {
+	uint8_t                mode;		// ENCODER_QUADRATURE, etc
+};
+
+// The core state must be the first base, so the assembly code finds it
+// at the start of the struct.  Empty parts take no space.
+template <class Traits>
+struct Encoder_internal_state : Encoder_core_state<typename Traits::count_t>,
+	Encoder_motion_state<Traits::track_motion>,
+	Encoder_compare_state<typename Traits::count_t, Traits::compare>,
+	Encoder_history_state<Traits::history>,
+	Encoder_retransmit_state<Traits::retransmit>,
+	Encoder_notify_state<typename Traits::count_t, Traits::notify>,
+	Encoder_movement_state<typename Traits::count_t, Traits::movement>,
+	Encoder_mode_state<Traits::pulse_modes> { };
+
+typedef Encoder_internal_state<EncoderDefaultTraits> Encoder_internal_state_t;
 
-class Encoder
+#include "utility/interrupt_dispatch.h"
+
+// Encoders started with beginLater() wait here until beginAll(), so
+// any number of them share a single settling delay.  With
+// ENCODER_DEFER_BEGIN, the constructors with pins use beginLater(),
+// which moves the delay out of the static constructors that run
+// before setup().  Then call Encoder::beginAll() at the start of
+// setup().  It starts every waiting encoder, of every BasicEncoder type.
+class EncoderStartup
+{
+public:
+	static void beginAll(uint32_t settleMicroseconds = ENCODER_SETTLE_MICROSECONDS) {
+		if (!pending()) return;
+		settle(settleMicroseconds);
+		while (pending()) {
+			EncoderStartup *p = pending();
+			pending() = p->next_pending;
+			(*p->start_function)(p);
+		}
+	}
+	// Wait for the inputs to settle.  delayMicroseconds() is limited to
+	// 16383 on AVR, so longer waits are split.  Never delay(), which
+	// needs timer0, not yet running in static constructors on AVR.
+	static void settle(uint32_t microseconds) {
+		while (microseconds > 16383) {
+			delayMicroseconds(16383);
+			microseconds -= 16383;
+		}
+		if (microseconds) delayMicroseconds(microseconds);
+	}
+protected:
+	// queue this encoder for beginAll(), only once if called again
+	void defer(void (*function)(EncoderStartup *)) {
+		start_function = function;
+		for (EncoderStartup *p = pending(); p; p = p->next_pending) {
+			if (p == this) return;
+		}
+		next_pending = pending();
+		pending() = this;
+	}
+private:
+	static EncoderStartup * & pending() {
+		static EncoderStartup *list = 0;
+		return list;
+	}
+	EncoderStartup *next_pending;
+	void (*start_function)(EncoderStartup *);
+};
+
+template <class A, class B> struct Encoder_same_traits { static const bool value = false; };
+template <class A> struct Encoder_same_traits<A, A> { static const bool value = true; };
+
+template <class Traits>
+class BasicEncoder : public EncoderDispatch<Encoder_internal_state<Traits>, BasicEncoder<Traits> >,
+	public EncoderStartup
 {
+public:
+	typedef Traits traits_type;
+	typedef typename Traits::count_t count_t;
+	typedef Encoder_internal_state<Traits> state_t;
+private:
+	typedef EncoderDispatch<state_t, BasicEncoder<Traits> > dispatch;
+#if !defined(ENCODER_USE_INTERRUPTS)
+	static_assert(Traits::interrupts == ENCODER_POLLED,
+		"ENCODER_DO_NOT_USE_INTERRUPTS allows only ENCODER_POLLED");
+#elif defined(ENCODER_OPTIMIZE_INTERRUPTS)
+	static_assert(Traits::interrupts == ENCODER_POLLED
+		|| Encoder_same_traits<Traits, EncoderDefaultTraits>::value,
+		"ENCODER_OPTIMIZE_INTERRUPTS vectors are used by Encoder, use ENCODER_POLLED");
+#endif
 public:
 	// one step setup like before
-	Encoder(uint8_t pin1, uint8_t pin2) { begin(pin1, pin2);}
+#ifdef ENCODER_DEFER_BEGIN
+	BasicEncoder(uint8_t pin1, uint8_t pin2) { beginLater(pin1, pin2);}
+	BasicEncoder(uint8_t pin1, uint8_t pin2, uint8_t mode) { beginLater(pin1, pin2, mode);}
+#else
+	BasicEncoder(uint8_t pin1, uint8_t pin2) { begin(pin1, pin2);}
+	BasicEncoder(uint8_t pin1, uint8_t pin2, uint8_t mode) { begin(pin1, pin2, mode);}
+#endif
 
 	// two step setup for platforms that have issues with constructor ordering
-	Encoder() { }
+	BasicEncoder() { }
 	void begin(uint8_t pin1, uint8_t pin2) {
+		begin_now(pin1, pin2, ENCODER_QUADRATURE);
+	}
+	// like begin(), but the initial state is read later by beginAll()
+	void beginLater(uint8_t pin1, uint8_t pin2) {
+		configure(pin1, pin2, ENCODER_QUADRATURE);
+		defer(start_deferred);
+	}
+	// Step/direction or up/down pulse inputs, only available when
+	// Traits::pulse_modes is true.  Both count on rising edges, and
+	// use the same interrupts and position as quadrature.  For
+	// ENCODER_STEP_DIR only the step pin (pin1) needs an interrupt.
+	void begin(uint8_t pin1, uint8_t pin2, uint8_t mode) {
+		static_assert(Traits::pulse_modes, "decode modes need Traits::pulse_modes");
+		begin_now(pin1, pin2, mode);
+	}
+	void beginLater(uint8_t pin1, uint8_t pin2, uint8_t mode) {
+		static_assert(Traits::pulse_modes, "decode modes need Traits::pulse_modes");
+		configure(pin1, pin2, mode);
+		defer(start_deferred);
+	}
+private:
+	void begin_now(uint8_t pin1, uint8_t pin2, uint8_t mode) {
+		configure(pin1, pin2, mode);
+		// allow time for a passive R-C filter to charge
+		// through the pullup resistors, before reading
+		// the initial state
+		settle(ENCODER_SETTLE_MICROSECONDS);
+		start();
+	}
+	// Pins and interrupts are ready after configure(), so counting is
+	// already possible while the inputs settle.  start() then takes a
+	// fresh initial state and clears anything counted meanwhile.
+	void configure(uint8_t pin1, uint8_t pin2, uint8_t mode) {
+		begin_mode(&encoder, mode);
 		#ifdef INPUT_PULLUP
 		pinMode(pin1, INPUT_PULLUP);
 		pinMode(pin2, INPUT_PULLUP);
@@ -94,74 +479,261 @@ public:
 		encoder.pin2_register = PIN_TO_BASEREG(pin2);
 		encoder.pin2_bitmask = PIN_TO_BITMASK(pin2);
 		encoder.position = 0;
-		// allow time for a passive R-C filter to charge
-		// through the pullup resistors, before reading
-		// the initial state
-		delayMicroseconds(2000);
+		encoder.state = initial_state();
+		begin_motion(&encoder);
+		begin_compare(&encoder);
+		begin_history(&encoder);
+		begin_retransmit(&encoder);
+		begin_notify(&encoder);
+		interrupts_in_use = 0;
+		if (Traits::interrupts != ENCODER_POLLED) {
+			interrupts_in_use = dispatch::attach_interrupt(pin1, &encoder);
+			if (interrupts_needed(&encoder) > 1) {
+				interrupts_in_use += dispatch::attach_interrupt(pin2, &encoder);
+			}
+		}
+		//update_finishup();  // to force linker to include the code (does not work)
+	}
+	void start() {
+		uint8_t s = initial_state();
+		if (Traits::interrupts != ENCODER_POLLED) noInterrupts();
+		encoder.state = s;
+		encoder.position = 0;
+		begin_motion(&encoder);
+		begin_movement(&encoder);
+		start_compare(&encoder);
+		if (Traits::interrupts != ENCODER_POLLED) interrupts();
+	}
+	static void start_deferred(EncoderStartup *p) {
+		static_cast<BasicEncoder *>(p)->start();
+	}
+	uint8_t initial_state() {
 		uint8_t s = 0;
 		if (DIRECT_PIN_READ(encoder.pin1_register, encoder.pin1_bitmask)) s |= 1;
 		if (DIRECT_PIN_READ(encoder.pin2_register, encoder.pin2_bitmask)) s |= 2;
-		encoder.state = s;
-#ifdef ENCODER_USE_INTERRUPTS
-		interrupts_in_use = attach_interrupt(pin1, &encoder);
-		interrupts_in_use += attach_interrupt(pin2, &encoder);
-#endif
-		//update_finishup();  // to force linker to include the code (does not work)
+		return s;
 	}
+public:
 
-
-#ifdef ENCODER_USE_INTERRUPTS
-	inline int32_t read() {
-		if (interrupts_in_use < 2) {
+	inline count_t read() {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&encoder);
+			return encoder.position;
+		}
+		if (interrupts_in_use < interrupts_needed(&encoder)) {
 			noInterrupts();
 			update(&encoder);
 		} else {
 			noInterrupts();
 		}
-		int32_t ret = encoder.position;
+		count_t ret = encoder.position;
 		interrupts();
 		return ret;
 	}
-	inline int32_t readAndReset() {
-		if (interrupts_in_use < 2) {
+	inline count_t readAndReset() {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&encoder);
+			count_t ret = encoder.position;
+			encoder.position = 0;
+			written(&encoder, ret);
+			return ret;
+		}
+		if (interrupts_in_use < interrupts_needed(&encoder)) {
 			noInterrupts();
 			update(&encoder);
 		} else {
 			noInterrupts();
 		}
-		int32_t ret = encoder.position;
+		count_t ret = encoder.position;
 		encoder.position = 0;
+		written(&encoder, ret);
 		interrupts();
 		return ret;
 	}
-	inline void write(int32_t p) {
+	inline void write(count_t p) {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			count_t before = encoder.position;
+			encoder.position = p;
+			written(&encoder, before);
+			return;
+		}
 		noInterrupts();
+		count_t before = encoder.position;
 		encoder.position = p;
+		written(&encoder, before);
 		interrupts();
 	}
-#else
-	inline int32_t read() {
-		update(&encoder);
-		return encoder.position;
+	// Total movement, only available when Traits::movement is true.
+	// It counts like the position, but write() and readAndReset() never
+	// change it, so the difference between 2 readings is only ever real
+	// motion.  It wraps around like the position.  See EncoderCursor.h.
+	inline count_t movement() {
+		static_assert(Traits::movement, "movement() needs Traits::movement");
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&encoder);
+			return movement_of(&encoder);
+		}
+		noInterrupts();
+		if (interrupts_in_use < interrupts_needed(&encoder)) update(&encoder);
+		count_t ret = movement_of(&encoder);
+		interrupts();
+		return ret;
+	}
+	// Switch between interrupts and polling, used by EncoderAdaptive.
+	// While detached, the count is only updated by read() and poll(),
+	// so poll() must be called often enough to see every state.
+	void detachInterrupts(uint8_t pin1, uint8_t pin2) {
+		if (Traits::interrupts == ENCODER_POLLED) return;
+		noInterrupts();
+		dispatch::detach_interrupt(pin1);
+		dispatch::detach_interrupt(pin2);
+		interrupts_in_use = 0;
+		interrupts();
 	}
-	inline int32_t readAndReset() {
+	void attachInterrupts(uint8_t pin1, uint8_t pin2) {
+		if (Traits::interrupts == ENCODER_POLLED) return;
+		noInterrupts();
+		interrupts_in_use = dispatch::attach_interrupt(pin1, &encoder);
+		if (interrupts_needed(&encoder) > 1) {
+			interrupts_in_use += dispatch::attach_interrupt(pin2, &encoder);
+		}
+		update(&encoder);	// catch up on any change while polling
+		interrupts();
+	}
+	// Read the pins now, returning the position.  Like readMotion(), it
+	// leaves interrupts as they were, so it may be called from a timer
+	// interrupt, see EncoderAdaptive.h.
+	inline count_t poll() {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&encoder);
+			return encoder.position;
+		}
+		encoder_irq_t s = encoder_irq_disable();
 		update(&encoder);
-		int32_t ret = encoder.position;
-		encoder.position = 0;
+		count_t ret = encoder.position;
+		encoder_irq_restore(s);
 		return ret;
 	}
-	inline void write(int32_t p) {
-		encoder.position = p;
+	// only available when Traits::track_motion is true.  Unlike read(),
+	// it leaves interrupts as they were, so it may be called from a
+	// timer interrupt, see EncoderMonitor.h.
+	inline Encoder_motion_t readMotion() {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&encoder);
+			return encoder.motion;
+		}
+		encoder_irq_t s = encoder_irq_disable();
+		if (interrupts_in_use < interrupts_needed(&encoder)) {
+			update(&encoder);
+		}
+		Encoder_motion_t ret = encoder.motion;
+		encoder_irq_restore(s);
+		return ret;
+	}
+	// Record the time and position of every count into a ring, only
+	// available when Traits::history is true.  Pass an EncoderHistory,
+	// or 0 to stop.  write() and readAndReset() record a step: the old
+	// and the new position, both at the time of the write.
+	void setHistory(Encoder_history_t *history) {
+		noInterrupts();
+		encoder.history = history;
+		interrupts();
+	}
+	// Call a function from the interrupt after every count, with the new
+	// position, only available when Traits::notify is true.  It is also
+	// called after write() and readAndReset(), with interrupts disabled,
+	// with the written position.  Keep it short, like any interrupt code.
+	// EncoderAwait.h uses it to resume coroutines.  Pass 0 to stop.
+	void onCount(void (*function)(void *context, count_t position), void *context = 0) {
+		noInterrupts();
+		encoder.notify = function;
+		encoder.notify_context = context;
+		interrupts();
+	}
+	// Position compare, only available when Traits::compare is true.
+	// targets must be sorted lowest first and stay valid while in use.
+	// Passing up through a target fires when the count reaches it,
+	// passing down fires when the count goes below it.  The interrupt
+	// only tests the next target above and below, so any number of
+	// targets costs the same per count.  write() and readAndReset()
+	// fire nothing, counting continues from the new position.
+	void setCompareTargets(const count_t *targets, uint8_t count) {
+		noInterrupts();
+		encoder.targets = targets;
+		encoder.count = count;
+		compare_seek(&encoder, encoder.position);
+		interrupts();
+	}
+	// called from the interrupt, with the target and +1 or -1
+	void onCompare(void (*function)(count_t target, int8_t direction)) {
+		noInterrupts();
+		encoder.function = function;
+		interrupts();
+	}
+	// Regenerate the count as quadrature on 2 more pins, only available
+	// when Traits::retransmit is true.  The interrupt toggles them with
+	// direct register writes right after counting, so the output follows
+	// the input within the interrupt latency.  Each output count is
+	// multiply / divide input counts, which must be 1 or less, so a 1024
+	// line encoder becomes 360 with (45, 128).  invert reverses the output
+	// direction.  The pins must already be configured with
+	// pinMode(pin, OUTPUT).  Both are set low, and count from there.
+	// A +/-2 count (a missed input edge) makes 2 output steps back to
+	// back, which the receiver must be fast enough to see.
+	// Returns false for a ratio above 1.  Pass 0 for both pins to stop.
+	// On Linux the outputs are only stored in encoder_linux_outputs(),
+	// for simulation.
+	bool setRetransmit(uint8_t pinA, uint8_t pinB, uint16_t multiply = 1,
+	  uint16_t divide = 1, bool invert = false) {
+		if (multiply == 0 || multiply > divide) return false;
+		noInterrupts();
+		encoder.out_a_register = 0;
+		if (pinA || pinB) {
+			encoder.out_a_register = output_register(pinA);
+			encoder.out_b_register = output_register(pinB);
+			encoder.out_a_bitmask = output_bitmask(pinA);
+			encoder.out_b_bitmask = output_bitmask(pinB);
+			*encoder.out_a_register = *encoder.out_a_register & ~encoder.out_a_bitmask;
+			*encoder.out_b_register = *encoder.out_b_register & ~encoder.out_b_bitmask;
+		}
+		encoder.multiply = multiply;
+		encoder.divide = divide;
+		encoder.remainder = 0;
+		encoder.phase = 0;
+		encoder.invert = invert;
+		interrupts();
+		return true;
+	}
+#if !defined(ENCODER_LINUX_GPIO)
+	// drive a pin with direct register writes when any target is hit,
+	// the pin must already be configured with pinMode(pin, OUTPUT).
+	// Not on Linux, which has no output registers, use onCompare().
+	void setCompareOutput(uint8_t pin, uint8_t action = ENCODER_OUTPUT_TOGGLE) {
+		noInterrupts();
+		encoder.output_register = (volatile IO_REG_TYPE *)portOutputRegister(digitalPinToPort(pin));
+		encoder.output_bitmask = digitalPinToBitMask(pin);
+		encoder.output_action = action;
+		interrupts();
 	}
 #endif
 private:
-	Encoder_internal_state_t encoder;
-#ifdef ENCODER_USE_INTERRUPTS
-	uint8_t interrupts_in_use;
+	static volatile IO_REG_TYPE * output_register(uint8_t pin) {
+#if defined(ENCODER_LINUX_GPIO)
+		return encoder_linux_outputs() + pin;
+#else
+		return (volatile IO_REG_TYPE *)portOutputRegister(digitalPinToPort(pin));
+#endif
+	}
+	static IO_REG_TYPE output_bitmask(uint8_t pin) {
+#if defined(ENCODER_LINUX_GPIO)
+		return 1;
+#else
+		return digitalPinToBitMask(pin);
 #endif
+	}
+	state_t encoder;
+	uint8_t interrupts_in_use;
 public:
-	static Encoder_internal_state_t * interruptArgs[ENCODER_ARGLIST_SIZE];
-
 //                           _______         _______       
 //               Pin1 ______|       |_______|       |______ Pin1
 // negative <---         _______         _______         __      --> positive
@@ -214,95 +786,102 @@ public:
 	// but it is public to allow static interrupt routines.
 	// DO NOT call update() directly from sketches.
 #if defined(IRAM_ATTR)
-	static IRAM_ATTR void update(Encoder_internal_state_t *arg) {
+	static IRAM_ATTR void update(state_t *arg) {
 #else
-	static void update(Encoder_internal_state_t *arg) {
+	static void update(state_t *arg) {
 #endif
 #if defined(__AVR__)
-		// The compiler believes this is just 1 line of code, so
-		// it will inline this function into each interrupt
-		// handler.  That's a tiny bit faster, but grows the code.
-		// Especially when used with ENCODER_OPTIMIZE_INTERRUPTS,
-		// the inline nature allows the ISR prologue and epilogue
-		// to only save/restore necessary registers, for very nice
-		// speed increase.
-		asm volatile (
-			"ld	r30, X+"		"\n\t"
-			"ld	r31, X+"		"\n\t"
-			"ld	r24, Z"			"\n\t"	// r24 = pin1 input
-			"ld	r30, X+"		"\n\t"
-			"ld	r31, X+"		"\n\t"
-			"ld	r25, Z"			"\n\t"  // r25 = pin2 input
-			"ld	r30, X+"		"\n\t"  // r30 = pin1 mask
-			"ld	r31, X+"		"\n\t"	// r31 = pin2 mask
-			"ld	r22, X"			"\n\t"	// r22 = state
-			"andi	r22, 3"			"\n\t"
-			"and	r24, r30"		"\n\t"
-			"breq	L%=1"			"\n\t"	// if (pin1)
-			"ori	r22, 4"			"\n\t"	//	state |= 4
-		"L%=1:"	"and	r25, r31"		"\n\t"
-			"breq	L%=2"			"\n\t"	// if (pin2)
-			"ori	r22, 8"			"\n\t"	//	state |= 8
-		"L%=2:" "ldi	r30, lo8(pm(L%=table))"	"\n\t"
-			"ldi	r31, hi8(pm(L%=table))"	"\n\t"
-			"add	r30, r22"		"\n\t"
-			"adc	r31, __zero_reg__"	"\n\t"
-			"asr	r22"			"\n\t"
-			"asr	r22"			"\n\t"
-			"st	X+, r22"		"\n\t"  // store new state
-			"ld	r22, X+"		"\n\t"
-			"ld	r23, X+"		"\n\t"
-			"ld	r24, X+"		"\n\t"
-			"ld	r25, X+"		"\n\t"
-			"ijmp"				"\n\t"	// jumps to update_finishup()
-			// TODO move this table to another static function,
-			// so it doesn't get needlessly duplicated.  Easier
-			// said than done, due to linker issues and inlining
-		"L%=table:"				"\n\t"
-			"rjmp	L%=end"			"\n\t"	// 0
-			"rjmp	L%=plus1"		"\n\t"	// 1
-			"rjmp	L%=minus1"		"\n\t"	// 2
-			"rjmp	L%=plus2"		"\n\t"	// 3
-			"rjmp	L%=minus1"		"\n\t"	// 4
-			"rjmp	L%=end"			"\n\t"	// 5
-			"rjmp	L%=minus2"		"\n\t"	// 6
-			"rjmp	L%=plus1"		"\n\t"	// 7
-			"rjmp	L%=plus1"		"\n\t"	// 8
-			"rjmp	L%=minus2"		"\n\t"	// 9
-			"rjmp	L%=end"			"\n\t"	// 10
-			"rjmp	L%=minus1"		"\n\t"	// 11
-			"rjmp	L%=plus2"		"\n\t"	// 12
-			"rjmp	L%=minus1"		"\n\t"	// 13
-			"rjmp	L%=plus1"		"\n\t"	// 14
-			"rjmp	L%=end"			"\n\t"	// 15
-		"L%=minus2:"				"\n\t"
-			"subi	r22, 2"			"\n\t"
-			"sbci	r23, 0"			"\n\t"
-			"sbci	r24, 0"			"\n\t"
-			"sbci	r25, 0"			"\n\t"
-			"rjmp	L%=store"		"\n\t"
-		"L%=minus1:"				"\n\t"
-			"subi	r22, 1"			"\n\t"
-			"sbci	r23, 0"			"\n\t"
-			"sbci	r24, 0"			"\n\t"
-			"sbci	r25, 0"			"\n\t"
-			"rjmp	L%=store"		"\n\t"
-		"L%=plus2:"				"\n\t"
-			"subi	r22, 254"		"\n\t"
-			"rjmp	L%=z"			"\n\t"
-		"L%=plus1:"				"\n\t"
-			"subi	r22, 255"		"\n\t"
-		"L%=z:"	"sbci	r23, 255"		"\n\t"
-			"sbci	r24, 255"		"\n\t"
-			"sbci	r25, 255"		"\n\t"
-		"L%=store:"				"\n\t"
-			"st	-X, r25"		"\n\t"
-			"st	-X, r24"		"\n\t"
-			"st	-X, r23"		"\n\t"
-			"st	-X, r22"		"\n\t"
-		"L%=end:"				"\n"
-		: : "x" (arg) : "r22", "r23", "r24", "r25", "r30", "r31");
-#else
+		// The assembly version only knows the plain 32 bit counter
+		if (sizeof(count_t) == 4 && !Traits::track_motion && !Traits::compare
+		  && !Traits::history && !Traits::retransmit && !Traits::notify
+		  && !Traits::movement && Traits::filter == ENCODER_FILTER_NONE
+		  && !Traits::pulse_modes) {
+			// The compiler believes this is just 1 line of code, so
+			// it will inline this function into each interrupt
+			// handler.  That's a tiny bit faster, but grows the code.
+			// Especially when used with ENCODER_OPTIMIZE_INTERRUPTS,
+			// the inline nature allows the ISR prologue and epilogue
+			// to only save/restore necessary registers, for very nice
+			// speed increase.
+			asm volatile (
+				"ld	r30, X+"		"\n\t"
+				"ld	r31, X+"		"\n\t"
+				"ld	r24, Z"			"\n\t"	// r24 = pin1 input
+				"ld	r30, X+"		"\n\t"
+				"ld	r31, X+"		"\n\t"
+				"ld	r25, Z"			"\n\t"  // r25 = pin2 input
+				"ld	r30, X+"		"\n\t"  // r30 = pin1 mask
+				"ld	r31, X+"		"\n\t"	// r31 = pin2 mask
+				"ld	r22, X"			"\n\t"	// r22 = state
+				"andi	r22, 3"			"\n\t"
+				"and	r24, r30"		"\n\t"
+				"breq	L%=1"			"\n\t"	// if (pin1)
+				"ori	r22, 4"			"\n\t"	//	state |= 4
+			"L%=1:"	"and	r25, r31"		"\n\t"
+				"breq	L%=2"			"\n\t"	// if (pin2)
+				"ori	r22, 8"			"\n\t"	//	state |= 8
+			"L%=2:" "ldi	r30, lo8(pm(L%=table))"	"\n\t"
+				"ldi	r31, hi8(pm(L%=table))"	"\n\t"
+				"add	r30, r22"		"\n\t"
+				"adc	r31, __zero_reg__"	"\n\t"
+				"asr	r22"			"\n\t"
+				"asr	r22"			"\n\t"
+				"st	X+, r22"		"\n\t"  // store new state
+				"ld	r22, X+"		"\n\t"
+				"ld	r23, X+"		"\n\t"
+				"ld	r24, X+"		"\n\t"
+				"ld	r25, X+"		"\n\t"
+				"ijmp"				"\n\t"	// jumps to update_finishup()
+				// TODO move this table to another static function,
+				// so it doesn't get needlessly duplicated.  Easier
+				// said than done, due to linker issues and inlining
+			"L%=table:"				"\n\t"
+				"rjmp	L%=end"			"\n\t"	// 0
+				"rjmp	L%=plus1"		"\n\t"	// 1
+				"rjmp	L%=minus1"		"\n\t"	// 2
+				"rjmp	L%=plus2"		"\n\t"	// 3
+				"rjmp	L%=minus1"		"\n\t"	// 4
+				"rjmp	L%=end"			"\n\t"	// 5
+				"rjmp	L%=minus2"		"\n\t"	// 6
+				"rjmp	L%=plus1"		"\n\t"	// 7
+				"rjmp	L%=plus1"		"\n\t"	// 8
+				"rjmp	L%=minus2"		"\n\t"	// 9
+				"rjmp	L%=end"			"\n\t"	// 10
+				"rjmp	L%=minus1"		"\n\t"	// 11
+				"rjmp	L%=plus2"		"\n\t"	// 12
+				"rjmp	L%=minus1"		"\n\t"	// 13
+				"rjmp	L%=plus1"		"\n\t"	// 14
+				"rjmp	L%=end"			"\n\t"	// 15
+			"L%=minus2:"				"\n\t"
+				"subi	r22, 2"			"\n\t"
+				"sbci	r23, 0"			"\n\t"
+				"sbci	r24, 0"			"\n\t"
+				"sbci	r25, 0"			"\n\t"
+				"rjmp	L%=store"		"\n\t"
+			"L%=minus1:"				"\n\t"
+				"subi	r22, 1"			"\n\t"
+				"sbci	r23, 0"			"\n\t"
+				"sbci	r24, 0"			"\n\t"
+				"sbci	r25, 0"			"\n\t"
+				"rjmp	L%=store"		"\n\t"
+			"L%=plus2:"				"\n\t"
+				"subi	r22, 254"		"\n\t"
+				"rjmp	L%=z"			"\n\t"
+			"L%=plus1:"				"\n\t"
+				"subi	r22, 255"		"\n\t"
+			"L%=z:"	"sbci	r23, 255"		"\n\t"
+				"sbci	r24, 255"		"\n\t"
+				"sbci	r25, 255"		"\n\t"
+			"L%=store:"				"\n\t"
+				"st	-X, r25"		"\n\t"
+				"st	-X, r24"		"\n\t"
+				"st	-X, r23"		"\n\t"
+				"st	-X, r22"		"\n\t"
+			"L%=end:"				"\n"
+			: : "x" (arg) : "r22", "r23", "r24", "r25", "r30", "r31");
+			return;
+		}
+#endif
 		uint8_t p1val = DIRECT_PIN_READ(arg->pin1_register, arg->pin1_bitmask);
 		uint8_t p2val = DIRECT_PIN_READ(arg->pin2_register, arg->pin2_bitmask);
 		uint8_t state = arg->state & 3;
@@ -313,21 +892,235 @@ public:
 		if (p2val) state |= 8;
 		//Serial.print(state); Serial.println(", ");
 		arg->state = (state >> 2);
+		if (pulse_mode(arg)) {
+			int8_t d = pulse_delta(pulse_mode(arg), state);
+			if (d) {
+				arg->position += d;
+				moved(arg, d);
+			}
+			return;
+		}
 		switch (state) {
 			case 1: case 7: case 8: case 14:
 				arg->position++;
+				moved(arg, 1);
 				return;
 			case 2: case 4: case 11: case 13:
 				arg->position--;
+				moved(arg, -1);
 				return;
 			case 3: case 12:
+				if (Traits::filter == ENCODER_FILTER_REJECT) return;
 				arg->position += 2;
+				moved(arg, 2);
 				return;
 			case 6: case 9:
+				if (Traits::filter == ENCODER_FILTER_REJECT) return;
 				arg->position -= 2;
+				moved(arg, -2);
 				return;
 		}
-#endif
+	}
+private:
+	// everything optional which happens after the count changes by
+	// delta, which is +/-1, or +/-2 when an edge was missed
+	static inline void moved(state_t *arg, int8_t delta) {
+		update_retransmit(arg, delta);
+		update_motion(arg, (delta > 0) ? 1 : -1);
+		update_history(arg, arg->position);
+		update_compare(arg, arg->position);
+		update_notify(arg, arg->position);
+		update_movement(arg, delta);
+	}
+	// everything optional which follows write() or readAndReset(), with
+	// interrupts disabled.  A written position is not movement, so no
+	// compare target fires, they are only found again around it.  The
+	// notify function still sees it, so nothing waits for a position
+	// which was written past.
+	static inline void written(state_t *arg, count_t before) {
+		write_history(arg, before, arg->position);
+		seek_compare(arg, arg->position);
+		update_notify(arg, arg->position);
+	}
+	// overloads pick the code for optional parts only for states which
+	// have them, and compile to nothing otherwise
+	static inline void begin_mode(Encoder_mode_state<false> *arg, uint8_t mode) { }
+	static inline void begin_mode(Encoder_mode_state<true> *arg, uint8_t mode) { arg->mode = mode; }
+	static inline uint8_t pulse_mode(Encoder_mode_state<false> *arg) { return ENCODER_QUADRATURE; }
+	static inline uint8_t pulse_mode(Encoder_mode_state<true> *arg) { return arg->mode; }
+	static inline uint8_t interrupts_needed(Encoder_mode_state<false> *arg) { return 2; }
+	static inline uint8_t interrupts_needed(Encoder_mode_state<true> *arg) {
+		return (arg->mode == ENCODER_STEP_DIR) ? 1 : 2;
+	}
+	//	new	new	old	old	step/dir	up/down
+	//	pin2	pin1	pin2	pin1
+	//	----	----	----	----	--------	-------
+	//	0	1	0	0	-1		+1
+	//	0	1	1	0	-1		+1
+	//	1	0	0	0			-1
+	//	1	0	0	1			-1
+	//	1	1	0	0	+1		0 (both)
+	//	1	1	0	1			-1
+	//	1	1	1	0	+1		+1
+	//	all others: no count
+	static inline int8_t pulse_delta(uint8_t mode, uint8_t state) {
+		static const int8_t table[2][16] = {
+			{0, 0, 0, 0, -1, 0, -1, 0, 0, 0, 0, 0, 1, 0, 1, 0},	// step/dir
+			{0, 0, 0, 0, 1, 0, 1, 0, -1, -1, 0, 0, 0, -1, 1, 0}	// up/down
+		};
+		return table[mode - 1][state];
+	}
+	static inline void begin_motion(Encoder_motion_state<false> *arg) { }
+	static inline void begin_motion(Encoder_motion_state<true> *arg) {
+		arg->motion.last_edge = micros();
+		arg->motion.interval = 0xFFFFFFFF;
+		arg->motion.direction = 0;
+		arg->motion.reversals = 0;
+	}
+	static inline void update_motion(Encoder_motion_state<false> *arg, int8_t dir) { }
+	static inline void update_motion(Encoder_motion_state<true> *arg, int8_t dir) {
+		uint32_t now = micros();
+		arg->motion.interval = now - arg->motion.last_edge;
+		arg->motion.last_edge = now;
+		if (dir != arg->motion.direction) {
+			if (arg->motion.direction) arg->motion.reversals++;
+			arg->motion.direction = dir;
+		}
+	}
+	static inline void begin_history(Encoder_history_state<false> *arg) { }
+	static inline void begin_history(Encoder_history_state<true> *arg) { arg->history = 0; }
+	static inline void update_history(Encoder_history_state<false> *arg, count_t position) { }
+	static inline void update_history(Encoder_history_state<true> *arg, count_t position) {
+		if (arg->history) encoder_history_record(arg->history, micros(), position);
+	}
+	// a written position is a step, both positions at the same time
+	static inline void write_history(Encoder_history_state<false> *arg, count_t before, count_t after) { }
+	static inline void write_history(Encoder_history_state<true> *arg, count_t before, count_t after) {
+		if (!arg->history) return;
+		uint32_t t = micros();
+		encoder_history_record(arg->history, t, before);
+		encoder_history_record(arg->history, t, after);
+	}
+	static inline void begin_retransmit(Encoder_retransmit_state<false> *arg) { }
+	static inline void begin_retransmit(Encoder_retransmit_state<true> *arg) {
+		arg->out_a_register = 0;
+	}
+	static inline void update_retransmit(Encoder_retransmit_state<false> *arg, int8_t delta) { }
+	static inline void update_retransmit(Encoder_retransmit_state<true> *arg, int8_t delta) {
+		if (!arg->out_a_register) return;
+		if (arg->invert) delta = -delta;
+		// multiply <= divide, so each count is at most 1 output step,
+		// and remainder carries the fraction in either direction
+		while (delta > 0) {
+			if (arg->remainder >= arg->divide - arg->multiply) {
+				arg->remainder -= arg->divide - arg->multiply;
+				retransmit_step(arg, 1);
+			} else {
+				arg->remainder += arg->multiply;
+			}
+			delta--;
+		}
+		while (delta < 0) {
+			if (arg->remainder < arg->multiply) {
+				arg->remainder += arg->divide - arg->multiply;
+				retransmit_step(arg, -1);
+			} else {
+				arg->remainder -= arg->multiply;
+			}
+			delta++;
+		}
+	}
+	// Exactly 1 pin toggles per step.  Going up from an even phase, or
+	// down from an odd one, that is B, otherwise A.
+	static inline void retransmit_step(Encoder_retransmit_state<true> *arg, int8_t dir) {
+		uint8_t phase = arg->phase;
+		if ((phase & 1) == (dir < 0)) {
+			*arg->out_b_register = *arg->out_b_register ^ arg->out_b_bitmask;
+		} else {
+			*arg->out_a_register = *arg->out_a_register ^ arg->out_a_bitmask;
+		}
+		arg->phase = (phase + dir) & 3;
+	}
+	static inline void begin_notify(Encoder_notify_state<count_t, false> *arg) { }
+	static inline void begin_notify(Encoder_notify_state<count_t, true> *arg) { arg->notify = 0; }
+	static inline void update_notify(Encoder_notify_state<count_t, false> *arg, count_t position) { }
+	static inline void update_notify(Encoder_notify_state<count_t, true> *arg, count_t position) {
+		if (arg->notify) (*arg->notify)(arg->notify_context, position);
+	}
+	static inline void begin_movement(Encoder_movement_state<count_t, false> *arg) { }
+	static inline void begin_movement(Encoder_movement_state<count_t, true> *arg) { arg->movement = 0; }
+	static inline void update_movement(Encoder_movement_state<count_t, false> *arg, int8_t delta) { }
+	static inline void update_movement(Encoder_movement_state<count_t, true> *arg, int8_t delta) {
+		arg->movement = (count_t)((uint32_t)arg->movement + (uint32_t)(int32_t)delta);
+	}
+	static inline count_t movement_of(Encoder_movement_state<count_t, false> *arg) { return 0; }
+	static inline count_t movement_of(Encoder_movement_state<count_t, true> *arg) { return arg->movement; }
+	typedef Encoder_compare_state<count_t, false> no_compare_t;
+	typedef Encoder_compare_state<count_t, true> compare_t;
+	static const count_t count_max = (count_t)(((uint32_t)1 << (sizeof(count_t) * 8 - 1)) - 1);
+	static const count_t count_min = -count_max - 1;
+	static inline void begin_compare(no_compare_t *arg) { }
+	static inline void begin_compare(compare_t *arg) {
+		arg->targets = 0;
+		arg->count = 0;
+		arg->function = 0;
+		arg->output_register = 0;
+		compare_seek(arg, 0);
+	}
+	// targets may already be set when a deferred start() happens
+	static inline void start_compare(no_compare_t *arg) { }
+	static inline void start_compare(compare_t *arg) { compare_seek(arg, 0); }
+	static inline void seek_compare(no_compare_t *arg, count_t position) { }
+	static inline void seek_compare(compare_t *arg, count_t position) { compare_seek(arg, position); }
+	static inline void update_compare(no_compare_t *arg, count_t position) { }
+	static inline void update_compare(compare_t *arg, count_t position) {
+		if (position >= arg->next_up) {
+			compare_hit(arg, position, 1);
+		} else if (position < arg->next_down) {
+			compare_hit(arg, position, -1);
+		}
+	}
+	// find which targets are above & below, with interrupts disabled
+	static void compare_seek(compare_t *arg, count_t position) {
+		uint8_t i = 0;
+		while (i < arg->count && arg->targets[i] <= position) i++;
+		arg->index = i;
+		compare_next(arg);
+	}
+	static inline void compare_next(compare_t *arg) {
+		uint8_t i = arg->index;
+		arg->next_up = (i < arg->count) ? arg->targets[i] : (count_t)count_max;
+		arg->next_down = (i > 0) ? arg->targets[i - 1] : (count_t)count_min;
+	}
+	// a 2 step count may pass more than one target
+	static void compare_hit(compare_t *arg, count_t position, int8_t dir) {
+		if (dir > 0) {
+			while (arg->index < arg->count && position >= arg->targets[arg->index]) {
+				compare_fire(arg, arg->targets[arg->index], 1);
+				arg->index++;
+			}
+		} else {
+			while (arg->index > 0 && position < arg->targets[arg->index - 1]) {
+				arg->index--;
+				compare_fire(arg, arg->targets[arg->index], -1);
+			}
+		}
+		compare_next(arg);
+	}
+	static inline void compare_fire(compare_t *arg, count_t target, int8_t dir) {
+		if (arg->output_register) {
+			switch (arg->output_action) {
+			  case ENCODER_OUTPUT_TOGGLE:
+				*arg->output_register = *arg->output_register ^ arg->output_bitmask;
+				break;
+			  case ENCODER_OUTPUT_HIGH:
+				*arg->output_register = *arg->output_register | arg->output_bitmask;
+				break;
+			  default:
+				*arg->output_register = *arg->output_register & ~arg->output_bitmask;
+			}
+		}
+		if (arg->function) (*arg->function)(target, dir);
 	}
 private:
 /*
@@ -388,567 +1181,10 @@ private:
 	}
 #endif
 */
-
-
-#ifdef ENCODER_USE_INTERRUPTS
-	// this giant function is an unfortunate consequence of Arduino's
-	// attachInterrupt function not supporting any way to pass a pointer
-	// or other context to the attached function.
-	static uint8_t attach_interrupt(uint8_t pin, Encoder_internal_state_t *state) {
-		switch (pin) {
-		#ifdef CORE_INT0_PIN
-			case CORE_INT0_PIN:
-				interruptArgs[0] = state;
-				attachInterrupt(0, isr0, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT1_PIN
-			case CORE_INT1_PIN:
-				interruptArgs[1] = state;
-				attachInterrupt(1, isr1, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT2_PIN
-			case CORE_INT2_PIN:
-				interruptArgs[2] = state;
-				attachInterrupt(2, isr2, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT3_PIN
-			case CORE_INT3_PIN:
-				interruptArgs[3] = state;
-				attachInterrupt(3, isr3, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT4_PIN
-			case CORE_INT4_PIN:
-				interruptArgs[4] = state;
-				attachInterrupt(4, isr4, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT5_PIN
-			case CORE_INT5_PIN:
-				interruptArgs[5] = state;
-				attachInterrupt(5, isr5, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT6_PIN
-			case CORE_INT6_PIN:
-				interruptArgs[6] = state;
-				attachInterrupt(6, isr6, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT7_PIN
-			case CORE_INT7_PIN:
-				interruptArgs[7] = state;
-				attachInterrupt(7, isr7, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT8_PIN
-			case CORE_INT8_PIN:
-				interruptArgs[8] = state;
-				attachInterrupt(8, isr8, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT9_PIN
-			case CORE_INT9_PIN:
-				interruptArgs[9] = state;
-				attachInterrupt(9, isr9, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT10_PIN
-			case CORE_INT10_PIN:
-				interruptArgs[10] = state;
-				attachInterrupt(10, isr10, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT11_PIN
-			case CORE_INT11_PIN:
-				interruptArgs[11] = state;
-				attachInterrupt(11, isr11, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT12_PIN
-			case CORE_INT12_PIN:
-				interruptArgs[12] = state;
-				attachInterrupt(12, isr12, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT13_PIN
-			case CORE_INT13_PIN:
-				interruptArgs[13] = state;
-				attachInterrupt(13, isr13, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT14_PIN
-			case CORE_INT14_PIN:
-				interruptArgs[14] = state;
-				attachInterrupt(14, isr14, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT15_PIN
-			case CORE_INT15_PIN:
-				interruptArgs[15] = state;
-				attachInterrupt(15, isr15, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT16_PIN
-			case CORE_INT16_PIN:
-				interruptArgs[16] = state;
-				attachInterrupt(16, isr16, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT17_PIN
-			case CORE_INT17_PIN:
-				interruptArgs[17] = state;
-				attachInterrupt(17, isr17, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT18_PIN
-			case CORE_INT18_PIN:
-				interruptArgs[18] = state;
-				attachInterrupt(18, isr18, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT19_PIN
-			case CORE_INT19_PIN:
-				interruptArgs[19] = state;
-				attachInterrupt(19, isr19, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT20_PIN
-			case CORE_INT20_PIN:
-				interruptArgs[20] = state;
-				attachInterrupt(20, isr20, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT21_PIN
-			case CORE_INT21_PIN:
-				interruptArgs[21] = state;
-				attachInterrupt(21, isr21, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT22_PIN
-			case CORE_INT22_PIN:
-				interruptArgs[22] = state;
-				attachInterrupt(22, isr22, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT23_PIN
-			case CORE_INT23_PIN:
-				interruptArgs[23] = state;
-				attachInterrupt(23, isr23, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT24_PIN
-			case CORE_INT24_PIN:
-				interruptArgs[24] = state;
-				attachInterrupt(24, isr24, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT25_PIN
-			case CORE_INT25_PIN:
-				interruptArgs[25] = state;
-				attachInterrupt(25, isr25, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT26_PIN
-			case CORE_INT26_PIN:
-				interruptArgs[26] = state;
-				attachInterrupt(26, isr26, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT27_PIN
-			case CORE_INT27_PIN:
-				interruptArgs[27] = state;
-				attachInterrupt(27, isr27, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT28_PIN
-			case CORE_INT28_PIN:
-				interruptArgs[28] = state;
-				attachInterrupt(28, isr28, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT29_PIN
-			case CORE_INT29_PIN:
-				interruptArgs[29] = state;
-				attachInterrupt(29, isr29, CHANGE);
-				break;
-		#endif
-
-		#ifdef CORE_INT30_PIN
-			case CORE_INT30_PIN:
-				interruptArgs[30] = state;
-				attachInterrupt(30, isr30, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT31_PIN
-			case CORE_INT31_PIN:
-				interruptArgs[31] = state;
-				attachInterrupt(31, isr31, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT32_PIN
-			case CORE_INT32_PIN:
-				interruptArgs[32] = state;
-				attachInterrupt(32, isr32, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT33_PIN
-			case CORE_INT33_PIN:
-				interruptArgs[33] = state;
-				attachInterrupt(33, isr33, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT34_PIN
-			case CORE_INT34_PIN:
-				interruptArgs[34] = state;
-				attachInterrupt(34, isr34, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT35_PIN
-			case CORE_INT35_PIN:
-				interruptArgs[35] = state;
-				attachInterrupt(35, isr35, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT36_PIN
-			case CORE_INT36_PIN:
-				interruptArgs[36] = state;
-				attachInterrupt(36, isr36, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT37_PIN
-			case CORE_INT37_PIN:
-				interruptArgs[37] = state;
-				attachInterrupt(37, isr37, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT38_PIN
-			case CORE_INT38_PIN:
-				interruptArgs[38] = state;
-				attachInterrupt(38, isr38, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT39_PIN
-			case CORE_INT39_PIN:
-				interruptArgs[39] = state;
-				attachInterrupt(39, isr39, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT40_PIN
-			case CORE_INT40_PIN:
-				interruptArgs[40] = state;
-				attachInterrupt(40, isr40, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT41_PIN
-			case CORE_INT41_PIN:
-				interruptArgs[41] = state;
-				attachInterrupt(41, isr41, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT42_PIN
-			case CORE_INT42_PIN:
-				interruptArgs[42] = state;
-				attachInterrupt(42, isr42, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT43_PIN
-			case CORE_INT43_PIN:
-				interruptArgs[43] = state;
-				attachInterrupt(43, isr43, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT44_PIN
-			case CORE_INT44_PIN:
-				interruptArgs[44] = state;
-				attachInterrupt(44, isr44, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT45_PIN
-			case CORE_INT45_PIN:
-				interruptArgs[45] = state;
-				attachInterrupt(45, isr45, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT46_PIN
-			case CORE_INT46_PIN:
-				interruptArgs[46] = state;
-				attachInterrupt(46, isr46, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT47_PIN
-			case CORE_INT47_PIN:
-				interruptArgs[47] = state;
-				attachInterrupt(47, isr47, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT48_PIN
-			case CORE_INT48_PIN:
-				interruptArgs[48] = state;
-				attachInterrupt(48, isr48, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT49_PIN
-			case CORE_INT49_PIN:
-				interruptArgs[49] = state;
-				attachInterrupt(49, isr49, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT50_PIN
-			case CORE_INT50_PIN:
-				interruptArgs[50] = state;
-				attachInterrupt(50, isr50, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT51_PIN
-			case CORE_INT51_PIN:
-				interruptArgs[51] = state;
-				attachInterrupt(51, isr51, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT52_PIN
-			case CORE_INT52_PIN:
-				interruptArgs[52] = state;
-				attachInterrupt(52, isr52, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT53_PIN
-			case CORE_INT53_PIN:
-				interruptArgs[53] = state;
-				attachInterrupt(53, isr53, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT54_PIN
-			case CORE_INT54_PIN:
-				interruptArgs[54] = state;
-				attachInterrupt(54, isr54, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT55_PIN
-			case CORE_INT55_PIN:
-				interruptArgs[55] = state;
-				attachInterrupt(55, isr55, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT56_PIN
-			case CORE_INT56_PIN:
-				interruptArgs[56] = state;
-				attachInterrupt(56, isr56, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT57_PIN
-			case CORE_INT57_PIN:
-				interruptArgs[57] = state;
-				attachInterrupt(57, isr57, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT58_PIN
-			case CORE_INT58_PIN:
-				interruptArgs[58] = state;
-				attachInterrupt(58, isr58, CHANGE);
-				break;
-		#endif
-		#ifdef CORE_INT59_PIN
-			case CORE_INT59_PIN:
-				interruptArgs[59] = state;
-				attachInterrupt(59, isr59, CHANGE);
-				break;
-		#endif
-			default:
-				return 0;
-		}
-		return 1;
-	}
-#endif // ENCODER_USE_INTERRUPTS
-
-
-#if defined(ENCODER_USE_INTERRUPTS) && !defined(ENCODER_OPTIMIZE_INTERRUPTS)
-	#ifdef CORE_INT0_PIN
-	static ENCODER_ISR_ATTR void isr0(void) { update(interruptArgs[0]); }
-	#endif
-	#ifdef CORE_INT1_PIN
-	static ENCODER_ISR_ATTR void isr1(void) { update(interruptArgs[1]); }
-	#endif
-	#ifdef CORE_INT2_PIN
-	static ENCODER_ISR_ATTR void isr2(void) { update(interruptArgs[2]); }
-	#endif
-	#ifdef CORE_INT3_PIN
-	static ENCODER_ISR_ATTR void isr3(void) { update(interruptArgs[3]);}
-	#endif
-	#ifdef CORE_INT4_PIN
-	static ENCODER_ISR_ATTR void isr4(void) { update(interruptArgs[4]); }
-	#endif
-	#ifdef CORE_INT5_PIN
-	static ENCODER_ISR_ATTR void isr5(void) { update(interruptArgs[5]); }
-	#endif
-	#ifdef CORE_INT6_PIN
-	static ENCODER_ISR_ATTR void isr6(void) { update(interruptArgs[6]); }
-	#endif
-	#ifdef CORE_INT7_PIN
-	static ENCODER_ISR_ATTR void isr7(void) { update(interruptArgs[7]); }
-	#endif
-	#ifdef CORE_INT8_PIN
-	static ENCODER_ISR_ATTR void isr8(void) { update(interruptArgs[8]); }
-	#endif
-	#ifdef CORE_INT9_PIN
-	static ENCODER_ISR_ATTR void isr9(void) { update(interruptArgs[9]); }
-	#endif
-	#ifdef CORE_INT10_PIN
-	static ENCODER_ISR_ATTR void isr10(void) { update(interruptArgs[10]); }
-	#endif
-	#ifdef CORE_INT11_PIN
-	static ENCODER_ISR_ATTR void isr11(void) { update(interruptArgs[11]); }
-	#endif
-	#ifdef CORE_INT12_PIN
-	static ENCODER_ISR_ATTR void isr12(void) { update(interruptArgs[12]); }
-	#endif
-	#ifdef CORE_INT13_PIN
-	static ENCODER_ISR_ATTR void isr13(void) { update(interruptArgs[13]); }
-	#endif
-	#ifdef CORE_INT14_PIN
-	static ENCODER_ISR_ATTR void isr14(void) { update(interruptArgs[14]); }
-	#endif
-	#ifdef CORE_INT15_PIN
-	static ENCODER_ISR_ATTR void isr15(void) { update(interruptArgs[15]); }
-	#endif
-	#ifdef CORE_INT16_PIN
-	static ENCODER_ISR_ATTR void isr16(void) { update(interruptArgs[16]); }
-	#endif
-	#ifdef CORE_INT17_PIN
-	static ENCODER_ISR_ATTR void isr17(void) { update(interruptArgs[17]); }
-	#endif
-	#ifdef CORE_INT18_PIN
-	static ENCODER_ISR_ATTR void isr18(void) { update(interruptArgs[18]); }
-	#endif
-	#ifdef CORE_INT19_PIN
-	static ENCODER_ISR_ATTR void isr19(void) { update(interruptArgs[19]); }
-	#endif
-	#ifdef CORE_INT20_PIN
-	static ENCODER_ISR_ATTR void isr20(void) { update(interruptArgs[20]); }
-	#endif
-	#ifdef CORE_INT21_PIN
-	static ENCODER_ISR_ATTR void isr21(void) { update(interruptArgs[21]); }
-	#endif
-	#ifdef CORE_INT22_PIN
-	static ENCODER_ISR_ATTR void isr22(void) { update(interruptArgs[22]); }
-	#endif
-	#ifdef CORE_INT23_PIN
-	static ENCODER_ISR_ATTR void isr23(void) { update(interruptArgs[23]); }
-	#endif
-	#ifdef CORE_INT24_PIN
-	static ENCODER_ISR_ATTR void isr24(void) { update(interruptArgs[24]); }
-	#endif
-	#ifdef CORE_INT25_PIN
-	static ENCODER_ISR_ATTR void isr25(void) { update(interruptArgs[25]); }
-	#endif
-	#ifdef CORE_INT26_PIN
-	static ENCODER_ISR_ATTR void isr26(void) { update(interruptArgs[26]); }
-	#endif
-	#ifdef CORE_INT27_PIN
-	static ENCODER_ISR_ATTR void isr27(void) { update(interruptArgs[27]); }
-	#endif
-	#ifdef CORE_INT28_PIN
-	static ENCODER_ISR_ATTR void isr28(void) { update(interruptArgs[28]); }
-	#endif
-	#ifdef CORE_INT29_PIN
-	static ENCODER_ISR_ATTR void isr29(void) { update(interruptArgs[29]); }
-	#endif
-	#ifdef CORE_INT30_PIN
-	static ENCODER_ISR_ATTR void isr30(void) { update(interruptArgs[30]); }
-	#endif
-	#ifdef CORE_INT31_PIN
-	static ENCODER_ISR_ATTR void isr31(void) { update(interruptArgs[31]); }
-	#endif
-	#ifdef CORE_INT32_PIN
-	static ENCODER_ISR_ATTR void isr32(void) { update(interruptArgs[32]); }
-	#endif
-	#ifdef CORE_INT33_PIN
-	static ENCODER_ISR_ATTR void isr33(void) { update(interruptArgs[33]); }
-	#endif
-	#ifdef CORE_INT34_PIN
-	static ENCODER_ISR_ATTR void isr34(void) { update(interruptArgs[34]); }
-	#endif
-	#ifdef CORE_INT35_PIN
-	static ENCODER_ISR_ATTR void isr35(void) { update(interruptArgs[35]); }
-	#endif
-	#ifdef CORE_INT36_PIN
-	static ENCODER_ISR_ATTR void isr36(void) { update(interruptArgs[36]); }
-	#endif
-	#ifdef CORE_INT37_PIN
-	static ENCODER_ISR_ATTR void isr37(void) { update(interruptArgs[37]); }
-	#endif
-	#ifdef CORE_INT38_PIN
-	static ENCODER_ISR_ATTR void isr38(void) { update(interruptArgs[38]); }
-	#endif
-	#ifdef CORE_INT39_PIN
-	static ENCODER_ISR_ATTR void isr39(void) { update(interruptArgs[39]); }
-	#endif
-	#ifdef CORE_INT40_PIN
-	static ENCODER_ISR_ATTR void isr40(void) { update(interruptArgs[40]); }
-	#endif
-	#ifdef CORE_INT41_PIN
-	static ENCODER_ISR_ATTR void isr41(void) { update(interruptArgs[41]); }
-	#endif
-	#ifdef CORE_INT42_PIN
-	static ENCODER_ISR_ATTR void isr42(void) { update(interruptArgs[42]); }
-	#endif
-	#ifdef CORE_INT43_PIN
-	static ENCODER_ISR_ATTR void isr43(void) { update(interruptArgs[43]); }
-	#endif
-	#ifdef CORE_INT44_PIN
-	static ENCODER_ISR_ATTR void isr44(void) { update(interruptArgs[44]); }
-	#endif
-	#ifdef CORE_INT45_PIN
-	static ENCODER_ISR_ATTR void isr45(void) { update(interruptArgs[45]); }
-	#endif
-	#ifdef CORE_INT46_PIN
-	static ENCODER_ISR_ATTR void isr46(void) { update(interruptArgs[46]); }
-	#endif
-	#ifdef CORE_INT47_PIN
-	static ENCODER_ISR_ATTR void isr47(void) { update(interruptArgs[47]); }
-	#endif
-	#ifdef CORE_INT48_PIN
-	static ENCODER_ISR_ATTR void isr48(void) { update(interruptArgs[48]); }
-	#endif
-	#ifdef CORE_INT49_PIN
-	static ENCODER_ISR_ATTR void isr49(void) { update(interruptArgs[49]); }
-	#endif
-	#ifdef CORE_INT50_PIN
-	static ENCODER_ISR_ATTR void isr50(void) { update(interruptArgs[50]); }
-	#endif
-	#ifdef CORE_INT51_PIN
-	static ENCODER_ISR_ATTR void isr51(void) { update(interruptArgs[51]); }
-	#endif
-	#ifdef CORE_INT52_PIN
-	static ENCODER_ISR_ATTR void isr52(void) { update(interruptArgs[52]); }
-	#endif
-	#ifdef CORE_INT53_PIN
-	static ENCODER_ISR_ATTR void isr53(void) { update(interruptArgs[53]); }
-	#endif
-	#ifdef CORE_INT54_PIN
-	static ENCODER_ISR_ATTR void isr54(void) { update(interruptArgs[54]); }
-	#endif
-	#ifdef CORE_INT55_PIN
-	static ENCODER_ISR_ATTR void isr55(void) { update(interruptArgs[55]); }
-	#endif
-	#ifdef CORE_INT56_PIN
-	static ENCODER_ISR_ATTR void isr56(void) { update(interruptArgs[56]); }
-	#endif
-	#ifdef CORE_INT57_PIN
-	static ENCODER_ISR_ATTR void isr57(void) { update(interruptArgs[57]); }
-	#endif
-	#ifdef CORE_INT58_PIN
-	static ENCODER_ISR_ATTR void isr58(void) { update(interruptArgs[58]); }
-	#endif
-	#ifdef CORE_INT59_PIN
-	static ENCODER_ISR_ATTR void isr59(void) { update(interruptArgs[59]); }
-	#endif
-#endif
 };
 
+typedef BasicEncoder<EncoderDefaultTraits> Encoder;
+
 #if defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_OPTIMIZE_INTERRUPTS)
 #if defined(__AVR__)
 #if defined(INT0_vect) && CORE_NUM_INTERRUPT > 0
@@ -0,0 +1,148 @@
+/* Encoder Library - adaptive switching between interrupts and polling
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderAdaptive_h_
+#define EncoderAdaptive_h_
+
+#include "Encoder.h"
+
+#ifdef ENCODER_OPTIMIZE_INTERRUPTS
+#error "EncoderAdaptive can not stop interrupts owned by ENCODER_OPTIMIZE_INTERRUPTS"
+#endif
+
+// With interrupts, CPU time grows with the count rate, until at very high
+// speed the interrupts use all of it (see the SpeedTest example).  Polling
+// from a timer costs the same at any speed, but wastes time when the
+// encoder is slow or stopped.  EncoderAdaptive uses both: interrupts
+// normally, switching to timer polling while the rate is above a high
+// threshold, and back to interrupts when it falls below a low threshold.
+//
+// Call tick() from a timer interrupt (IntervalTimer on Teensy, or any
+// periodic timer) at the rate given to the constructor.  In interrupt
+// mode tick() only counts, and looks at the position once per window.
+// In polling mode every tick() reads the pins, so the tick rate limits
+// the speed which can be counted: at most 1 count per tick.  Keep the
+// high threshold well below the tick rate, half is a good choice, so
+// nothing is lost while the rate is measured.
+//
+// tick() only decides when to switch.  Attaching and detaching the pin
+// interrupts is not safe inside another interrupt on every board (ESP32
+// for one), so update() does it, and must be called often from loop().
+// Until then the old mode simply continues.  Polling starts before the
+// interrupts stop and ends after they restart, so no edge goes unseen.
+//
+// The rate is the number of counts per second.  Contact bounce which
+// counts up and down cancels out, so it is not seen as a high rate.
+// The thresholds are turned into counts per window when they are set,
+// so tick() has no divide.
+
+template <class EncoderType>
+class BasicEncoderAdaptive
+{
+public:
+	BasicEncoderAdaptive(EncoderType &enc, uint8_t pin1, uint8_t pin2, uint32_t tickHz)
+	  : encoder(enc), p1(pin1), p2(pin2) {
+		tick_rate = tickHz ? tickHz : 1;
+		high = tick_rate / 2;
+		low = tick_rate / 4;
+		window = (tick_rate >= 100) ? tick_rate / 100 : 1;	// 10 ms
+		ticks = 0;
+		last = encoder.read();
+		counts = 0;
+		is_polling = false;
+		want_polling = false;
+		switches = 0;
+		set_limits();
+	}
+	// counts/sec to switch to polling, and back to interrupts
+	void setThresholds(uint32_t highRate, uint32_t lowRate) {
+		high = highRate;
+		low = (lowRate < highRate) ? lowRate : highRate;
+		set_limits();
+	}
+	// number of ticks between rate measurements
+	void setWindow(uint16_t windowTicks) {
+		window = windowTicks ? windowTicks : 1;
+		set_limits();
+	}
+
+	// from the timer interrupt, interrupts stay as they were
+	void tick() {
+		if (is_polling) {
+			typename EncoderType::count_t now = encoder.poll();
+			if (++ticks < window) return;
+			measure(now);
+		} else {
+			if (++ticks < window) return;
+			measure(encoder.poll());
+		}
+	}
+	// from loop(), switches mode when tick() asks for it
+	void update() {
+		if (want_polling == is_polling) return;
+		if (want_polling) {
+			is_polling = true;
+			encoder.detachInterrupts(p1, p2);
+		} else {
+			encoder.attachInterrupts(p1, p2);
+			is_polling = false;
+		}
+		switches++;
+	}
+	bool polling() const { return is_polling; }
+	// counts/sec, last window
+	uint32_t rate() const { return (uint64_t)counts * tick_rate / window; }
+	uint32_t switches;		// mode changes so far
+private:
+	void measure(typename EncoderType::count_t now) {
+		ticks = 0;
+		typename EncoderType::count_t d = (typename EncoderType::count_t)((uint32_t)now - (uint32_t)last);
+		uint32_t c = (d < 0) ? -(int32_t)d : d;
+		last = now;
+		counts = c;
+		if (c > high_counts) want_polling = true;
+		else if (c < low_counts) want_polling = false;
+	}
+	// rate > high is counts > high * window / tick_rate, and rate < low
+	// is counts < low * window / tick_rate rounded up
+	void set_limits() {
+		uint64_t h = (uint64_t)high * window / tick_rate;
+		uint64_t l = ((uint64_t)low * window + tick_rate - 1) / tick_rate;
+		high_counts = (h < 0xFFFFFFFF) ? h : 0xFFFFFFFF;
+		low_counts = (l < 0xFFFFFFFF) ? l : 0xFFFFFFFF;
+	}
+	EncoderType &encoder;
+	uint8_t p1, p2;
+	uint32_t tick_rate;
+	uint32_t high, low;
+	uint32_t high_counts, low_counts;
+	uint16_t window, ticks;
+	typename EncoderType::count_t last;
+	volatile uint32_t counts;
+	volatile bool is_polling;
+	volatile bool want_polling;
+};
+
+typedef BasicEncoderAdaptive<Encoder> EncoderAdaptive;
+
+#endif
@@ -0,0 +1,139 @@
+/* Encoder Library - modular angle and revolution counting
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderAngle_h_
+#define EncoderAngle_h_
+
+#include "Encoder.h"
+
+// EncoderAngle turns the raw count from an Encoder into an angle within
+// one revolution (0 to countsPerRevolution-1) plus a signed turn count.
+//
+// The obvious way, position % cpr and position / cpr, costs a 32 bit
+// divide on every read.  On AVR that is several hundred cycles.  Instead,
+// the start of the current revolution is remembered and only moved when
+// the position leaves it.  Normally that is a single subtract & compare.
+// Large jumps (a long time between reads, or a write() to the Encoder)
+// are handled with a shift-and-subtract loop, at most 32 steps, never a
+// divide.
+//
+// Nothing is added to the interrupt routine.  Each call takes one atomic
+// snapshot with Encoder::read(), so angle and turns computed together
+// always describe the same position.  Use readAngle(turns) when you need
+// both as a matched pair.
+//
+// An EncoderAngle object is meant to be used from one context (normally
+// loop).  The Encoder may keep counting in its interrupts.  Angle and
+// turns always follow the Encoder's position, so write() or
+// readAndReset() on the Encoder act like movement to the new position:
+// the next read counts the turns from the old position to the new one,
+// just as if the shaft had turned there, and the zero point stays where
+// it was.  Use zero() afterwards to make the new position angle 0 of
+// turn 0 instead.
+
+template <class EncoderType>
+class BasicEncoderAngle
+{
+	static_assert(sizeof(typename EncoderType::count_t) == 4,
+		"EncoderAngle needs a 32 bit count");
+public:
+	BasicEncoderAngle(EncoderType &enc, uint32_t countsPerRevolution) : encoder(enc) {
+		setCountsPerRevolution(countsPerRevolution);
+	}
+	// angle 0, turn 0 is position 0 of the Encoder, so readAngle() and
+	// readTurns() give the same result as position % cpr and the floor
+	// of position / cpr.
+	void setCountsPerRevolution(uint32_t countsPerRevolution) {
+		cpr = countsPerRevolution ? countsPerRevolution : 1;
+		base = 0;
+		angle = 0;
+		turns = 0;
+	}
+	uint32_t countsPerRevolution() const { return cpr; }
+	// re-reference, making the present position angle 0 of turn 0
+	void zero() {
+		base = encoder.read();
+		angle = 0;
+		turns = 0;
+	}
+	inline int32_t readAngle() {
+		track(encoder.read());
+		return angle;
+	}
+	inline int32_t readTurns() {
+		track(encoder.read());
+		return turns;
+	}
+	// angle and turns from the same snapshot of the position
+	inline int32_t readAngle(int32_t &turnsOut) {
+		track(encoder.read());
+		turnsOut = turns;
+		return angle;
+	}
+private:
+	inline void track(int32_t position) {
+		// unsigned math, so the 32 bit position may wrap around
+		uint32_t d = (uint32_t)position - (uint32_t)base;
+		if (d < cpr) {
+			angle = d;	// still within the same revolution
+			return;
+		}
+		if ((int32_t)d > 0) {
+			turns += revolutions(d);
+			angle = d;
+		} else {
+			// moving backward: count whole revolutions rounded up,
+			// so the remaining angle is positive
+			d = (uint32_t)base - (uint32_t)position + cpr - 1;
+			turns -= revolutions(d);
+			angle = cpr - 1 - d;
+		}
+		base = (int32_t)((uint32_t)position - (uint32_t)angle);
+	}
+	// d = d % cpr, returning d / cpr, using only shifts and subtracts
+	uint32_t revolutions(uint32_t &d) {
+		uint32_t step = cpr, n = 1, count = 0;
+		while (step <= (d >> 1)) {
+			step <<= 1;
+			n <<= 1;
+		}
+		while (d >= cpr) {
+			if (d >= step) {
+				d -= step;
+				count += n;
+			}
+			step >>= 1;
+			n >>= 1;
+		}
+		return count;
+	}
+	EncoderType &encoder;
+	uint32_t cpr;
+	int32_t  base;
+	int32_t  angle;
+	int32_t  turns;
+};
+
+typedef BasicEncoderAngle<Encoder> EncoderAngle;
+
+#endif
@@ -0,0 +1,334 @@
+/* Encoder Library - C++20 coroutine awaitables
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderAwait_h_
+#define EncoderAwait_h_
+
+#include "Encoder.h"
+
+#if !defined(__cpp_impl_coroutine)
+#error "EncoderAwait.h needs C++20 coroutines, for example -std=c++20"
+#endif
+#include <coroutine>
+#include <type_traits>
+
+// EncoderAwait lets a coroutine wait for the encoder instead of looping
+// around read().  The interrupt (or EncoderGpioEvents on Linux) checks
+// the waiting coroutines after every count and hands the ones which are
+// done to an executor, which resumes them.  Nothing polls, so a task
+// waiting for a position uses no CPU time at all until it gets there.
+//
+//   struct Traits : EncoderDefaultTraits {
+//     static const bool notify = true;     // or #define ENCODER_NOTIFY
+//   };
+//   BasicEncoder<Traits> myEnc;
+//   EncoderAwaitLoop loop;                 // Linux, see below
+//   BasicEncoderAwait<BasicEncoder<Traits>, EncoderAwaitLoop> waits(myEnc, loop);
+//
+//   EncoderTask home() {
+//     int32_t p = co_await waits.waitUntilPosition(1000);
+//     if (!co_await waits.waitForMotion(50, 200000)) stalled();
+//     p = co_await waits.nextEdge();
+//   }
+//   home();          // runs to the first co_await
+//   loop.run();      // resumes it as the encoder moves
+//
+//   waitUntilPosition(target)   resumes when the position reaches or
+//                               passes target, with that position
+//   waitForMotion(delta, us)    true when the position moves delta
+//                               counts either way, false after us
+//                               microseconds (0 = no time limit)
+//   nextEdge()                  the next count, with its position
+//
+// write() and readAndReset() are checked like a count, with the
+// written position: a target written past resumes waitUntilPosition(),
+// a jump of delta or more resumes waitForMotion(), and nextEdge()
+// resumes with the written position.
+//
+// Waiters are linked through the awaiters themselves, which live in
+// the coroutine frames, so waiting allocates nothing.  The interrupt
+// work is a short walk of that list per count.
+//
+// Coroutines must be started from, and are always resumed on, the
+// executor's thread.  The executor provides:
+//
+//   void post(std::coroutine_handle<> h)   resume h soon, called from
+//                                          the interrupt, so it must be
+//                                          safe there
+//   void addTimer(EncoderAwaitTimer *t, uint32_t micros)
+//   void cancelTimer(EncoderAwaitTimer *t)  timers are only used from
+//                                          the executor's thread
+//
+// EncoderAwaitLoop is the executor for Linux.  For an RTOS, post() can
+// send the handle to a queue from the interrupt (xQueueSendFromISR on
+// FreeRTOS), with a task receiving and resuming them.
+
+// Fire and forget coroutine: runs at once until its first co_await,
+// and frees itself when it returns.
+struct EncoderTask {
+	struct promise_type {
+		EncoderTask get_return_object() { return EncoderTask(); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() { }
+		void unhandled_exception() { }
+	};
+};
+
+struct EncoderAwaitTimer {
+	uint64_t               deadline;	// executor's clock
+	void                   (*fire)(EncoderAwaitTimer *timer);
+	EncoderAwaitTimer *    next;
+};
+
+template <class EncoderType, class Executor>
+class BasicEncoderAwait
+{
+	static_assert(EncoderType::traits_type::notify,
+		"EncoderAwait needs Traits::notify");
+public:
+	typedef typename EncoderType::count_t count_t;
+
+	// One co_await.  The interrupt resumes it when the position is at
+	// or below low, at or above high, or on any count.
+	struct Waiter : EncoderAwaitTimer {
+		BasicEncoderAwait *    owner;
+		Waiter *               link;
+		std::coroutine_handle<> handle;
+		count_t                low;
+		count_t                high;
+		count_t                position;	// when resumed
+		uint32_t               timeout;		// microseconds, 0 = none
+		bool                   any;
+		bool                   timed_out;
+		bool done(count_t p) const { return any || p <= low || p >= high; }
+	};
+	template <typename Result>
+	struct Awaiter {
+		Waiter w;
+		// only a position test, nextEdge() always waits
+		bool await_ready() {
+			if (w.any) return false;
+			w.position = w.owner->encoder.read();
+			return w.done(w.position);
+		}
+		bool await_suspend(std::coroutine_handle<> h) {
+			w.handle = h;
+			w.owner->add(&w);
+			if (!w.any) {
+				// a count between await_ready and add() would be missed
+				count_t p = w.owner->encoder.read();
+				if (w.done(p) && w.owner->remove(&w)) {
+					w.position = p;
+					return false;
+				}
+			}
+			if (w.timeout) {
+				w.fire = &BasicEncoderAwait::timer_fired;
+				w.owner->executor.addTimer(&w, w.timeout);
+			}
+			return true;
+		}
+		Result await_resume() {
+			if (w.timeout) w.owner->executor.cancelTimer(&w);
+			if constexpr (std::is_same<Result, bool>::value) {
+				return !w.timed_out;
+			} else {
+				return w.position;
+			}
+		}
+	};
+
+	BasicEncoderAwait(EncoderType &enc, Executor &exec)
+	  : encoder(enc), executor(exec), waiters(0) { }
+	// after the Encoder's begin()
+	void begin() { encoder.onCount(&BasicEncoderAwait::notify, this); }
+
+	Awaiter<count_t> waitUntilPosition(count_t target) {
+		Awaiter<count_t> a = prepare<count_t>(0);
+		if (encoder.read() < target) {
+			a.w.high = target;
+		} else {
+			a.w.low = target;
+		}
+		return a;
+	}
+	Awaiter<bool> waitForMotion(count_t delta, uint32_t timeoutMicros = 0) {
+		Awaiter<bool> a = prepare<bool>(timeoutMicros);
+		count_t p = encoder.read();
+		a.w.low = p - delta;
+		a.w.high = p + delta;
+		return a;
+	}
+	Awaiter<count_t> nextEdge() {
+		Awaiter<count_t> a = prepare<count_t>(0);
+		a.w.any = true;
+		return a;
+	}
+private:
+	template <typename Result>
+	Awaiter<Result> prepare(uint32_t timeout) {
+		Awaiter<Result> a;
+		a.w.owner = this;
+		a.w.link = 0;
+		a.w.low = count_min;
+		a.w.high = count_max;
+		a.w.position = 0;
+		a.w.timeout = timeout;
+		a.w.any = false;
+		a.w.timed_out = false;
+		return a;
+	}
+	void add(Waiter *w) {
+		noInterrupts();
+		w->link = waiters;
+		waiters = w;
+		interrupts();
+	}
+	// false if the interrupt already took it
+	bool remove(Waiter *w) {
+		bool found = false;
+		noInterrupts();
+		for (Waiter **p = &waiters; *p; p = &(*p)->link) {
+			if (*p == w) {
+				*p = w->link;
+				found = true;
+				break;
+			}
+		}
+		interrupts();
+		return found;
+	}
+	// from the interrupt, after every count
+	static void notify(void *context, count_t position) {
+		BasicEncoderAwait *self = (BasicEncoderAwait *)context;
+		Waiter **p = &self->waiters;
+		while (*p) {
+			Waiter *w = *p;
+			if (w->done(position)) {
+				*p = w->link;
+				w->position = position;
+				self->executor.post(w->handle);
+			} else {
+				p = &w->link;
+			}
+		}
+	}
+	// from the executor, unless the interrupt resumed it first
+	static void timer_fired(EncoderAwaitTimer *timer) {
+		Waiter *w = static_cast<Waiter *>(timer);
+		if (!w->owner->remove(w)) return;
+		w->timed_out = true;
+		w->position = w->owner->encoder.read();
+		w->timeout = 0;		// already off the timer list
+		w->owner->executor.post(w->handle);
+	}
+	static const count_t count_max = (count_t)(((uint32_t)1 << (sizeof(count_t) * 8 - 1)) - 1);
+	static const count_t count_min = -count_max - 1;
+	EncoderType &encoder;
+	Executor &executor;
+	Waiter *waiters;
+};
+
+#if defined(ENCODER_LINUX_GPIO)
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+
+// Executor for Linux.  run() sleeps on a condition variable until a
+// coroutine is posted or a timer is due, then resumes them, so the
+// thread uses no CPU while nothing happens.  post() may be called from
+// any thread, including the one running EncoderGpioEvents::process().
+class EncoderAwaitLoop
+{
+public:
+	EncoderAwaitLoop() : timers(0), stopping(false) { }
+	void post(std::coroutine_handle<> h) {
+		std::lock_guard<std::mutex> guard(lock);
+		ready.push_back(h);
+		wake.notify_one();
+	}
+	void addTimer(EncoderAwaitTimer *t, uint32_t micros) {
+		std::lock_guard<std::mutex> guard(lock);
+		t->deadline = now() + micros;
+		EncoderAwaitTimer **p = &timers;
+		while (*p && (*p)->deadline <= t->deadline) p = &(*p)->next;
+		t->next = *p;
+		*p = t;
+		wake.notify_one();
+	}
+	void cancelTimer(EncoderAwaitTimer *t) {
+		std::lock_guard<std::mutex> guard(lock);
+		for (EncoderAwaitTimer **p = &timers; *p; p = &(*p)->next) {
+			if (*p == t) {
+				*p = t->next;
+				break;
+			}
+		}
+	}
+	// resume coroutines until stop()
+	void run() {
+		std::unique_lock<std::mutex> guard(lock);
+		while (!stopping) {
+			if (!ready.empty()) {
+				std::coroutine_handle<> h = ready.front();
+				ready.pop_front();
+				guard.unlock();
+				h.resume();
+				guard.lock();
+			} else if (timers && timers->deadline <= now()) {
+				EncoderAwaitTimer *t = timers;
+				timers = t->next;
+				guard.unlock();
+				(*t->fire)(t);
+				guard.lock();
+			} else if (timers) {
+				wake.wait_until(guard, std::chrono::steady_clock::time_point(
+					std::chrono::microseconds(timers->deadline)));
+			} else {
+				wake.wait(guard);
+			}
+		}
+		stopping = false;
+	}
+	// from any thread, or a coroutine, run() returns
+	void stop() {
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+		wake.notify_one();
+	}
+	static uint64_t now() {
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+private:
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<std::coroutine_handle<> > ready;
+	EncoderAwaitTimer *timers;	// soonest first
+	bool stopping;
+};
+#endif
+
+#endif
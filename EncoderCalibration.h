@@ -0,0 +1,203 @@
+/* Encoder Library - calibration table for repeatable position error
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderCalibration_h_
+#define EncoderCalibration_h_
+
+#include "Encoder.h"
+
+// EncoderCalibration corrects repeatable position errors, like a linear
+// scale which is a little long in places, or an eccentric rotary disk.
+// A table of points gives the correction at chosen positions, and
+// between points it is interpolated along a straight line, so a smooth
+// error needs only a few points.  extras/linux/calibrate.cpp builds the
+// table from a trace of Encoder counts against a reference.
+//
+//   const EncoderCalibrationPoint table[] = {
+//     {0, 0}, {1200, 310}, {5000, 690}, {9000, -128},   // 1/256 counts
+//   };
+//   EncoderCalibration axis(myEnc, table, 4);
+//   long where = axis.readCorrected();
+//
+// Positions are Encoder counts from your home position, so after homing
+// set the Encoder to the home position with write().  Corrections are in
+// 1/256 counts (ENCODER_CALIBRATION_SCALE), so the interpolation keeps
+// fractions, and the result is rounded to whole counts.  Before the
+// first point and after the last, the correction stays at the nearest
+// end.  With a period (counts per revolution), positions are taken
+// modulo the period, the points must be within 0 to period-1, and the
+// last point interpolates back to the first.
+//
+// Searching the table on every read would take time, so the segment
+// the position is in is remembered, with its slope.  A read within the
+// same segment is 1 multiply and a shift.  Moving into the next segment
+// takes 1 divide, for the new slope, also across the end of a
+// revolution, and bigger jumps a binary search.
+// Nothing is added to the interrupt routine.  Like EncoderAngle, use
+// each EncoderCalibration from one context (normally loop).
+
+#define ENCODER_CALIBRATION_SCALE	256
+
+typedef struct {
+	int32_t                position;	// counts, lowest first
+	int16_t                correction;	// 1/256 counts, added to position
+} EncoderCalibrationPoint;
+
+template <class EncoderType>
+class BasicEncoderCalibration
+{
+	static_assert(sizeof(typename EncoderType::count_t) == 4,
+		"EncoderCalibration needs a 32 bit count");
+public:
+	BasicEncoderCalibration(EncoderType &enc, const EncoderCalibrationPoint *table,
+	  uint16_t count, uint32_t period = 0) : encoder(enc) {
+		setTable(table, count, period);
+	}
+	// the table must stay valid while in use, count below 32768
+	void setTable(const EncoderCalibrationPoint *table, uint16_t count, uint32_t period = 0) {
+		points = table;
+		num = count;
+		cpr = period;
+		base = 0;
+		seeks = 0;
+		if (num) load(cpr ? 0 : -1);
+	}
+	inline int32_t readCorrected() {
+		return correct(encoder.read());
+	}
+	// any position, such as one from EncoderHistory
+	int32_t correct(int32_t position) {
+		if (!num) return position;
+		return position + ((correction(position) + ENCODER_CALIBRATION_SCALE / 2)
+			>> 8);
+	}
+	// the interpolated correction in 1/256 counts
+	int32_t correction(int32_t position) {
+		if (!num) return 0;
+		int32_t x = position;
+		if (cpr) {
+			x = revolution(position);
+			if (x < points[0].position) x += cpr;
+		}
+		if (x < lo || x >= hi) seek(x);
+		return c0 + (int32_t)((((int64_t)x - lo) * slope) >> 16);
+	}
+	uint32_t seeks;		// segments loaded, for measuring
+private:
+	// position within the revolution, 0 to cpr-1, normally without
+	// a divide, by remembering where the revolution starts
+	int32_t revolution(int32_t position) {
+		uint32_t d = (uint32_t)position - (uint32_t)base;
+		if (d < cpr) return d;
+		if (d - cpr < cpr) {
+			base += cpr;
+		} else if (d + cpr < cpr) {
+			base -= cpr;
+		} else {
+			int32_t r = position % (int32_t)cpr;
+			if (r < 0) r += cpr;
+			base = position - r;
+		}
+		return (uint32_t)position - (uint32_t)base;
+	}
+	void seek(int32_t x) {
+		int16_t last = num - 1;
+		// Around the end of a revolution, x wraps: forward out of the
+		// last segment comes below lo, backward out of segment 0 above hi.
+		if (cpr && last > 0) {
+			if (index == last && x < points[1].position) {
+				load(0);
+				return;
+			}
+			if (index == 0 && x >= points[last].position) {
+				load(last);
+				return;
+			}
+		}
+		// the neighbor first, it is where a moving encoder goes
+		if (x >= hi && index < last) {
+			load(index + 1);
+			if (x < hi) return;
+		} else if (x < lo && index > (cpr ? 0 : -1)) {
+			load(index - 1);
+			if (x >= lo) return;
+		}
+		// binary search for the last point at or below x
+		int16_t i = -1, j = last;
+		while (i < j) {
+			int16_t mid = (i + j + 1) / 2;
+			if (points[mid].position <= x) {
+				i = mid;
+			} else {
+				j = mid - 1;
+			}
+		}
+		load(i);
+	}
+	// segment i runs from point i to i+1.  -1 is before the first point,
+	// and the last runs on to the end, or around to the first point.
+	void load(int16_t i) {
+		index = i;
+		seeks++;
+		int32_t c1;
+		if (i < 0) {
+			lo = (int32_t)0x80000000;
+			hi = points[0].position;
+			c0 = points[0].correction;
+			slope = 0;
+			return;
+		}
+		lo = points[i].position;
+		c0 = points[i].correction;
+		if (i + 1 < num) {
+			hi = points[i + 1].position;
+			c1 = points[i + 1].correction;
+		} else if (cpr) {
+			hi = points[0].position + cpr;
+			c1 = points[0].correction;
+		} else {
+			hi = 0x7FFFFFFF;
+			slope = 0;
+			return;
+		}
+		// Only a 1 count segment can overflow, where x - lo is always 0,
+		// so limiting the slope changes nothing.
+		int64_t s = ((int64_t)(c1 - c0) << 16) / (hi - lo);
+		if (s > 0x7FFFFFFF) s = 0x7FFFFFFF;
+		if (s < -0x7FFFFFFF) s = -0x7FFFFFFF;
+		slope = (int32_t)s;
+	}
+	EncoderType &encoder;
+	const EncoderCalibrationPoint *points;
+	uint16_t num;
+	int16_t  index;		// present segment
+	uint32_t cpr;
+	int32_t  base;		// start of the present revolution
+	int32_t  lo, hi;	// present segment, lo <= x < hi
+	int32_t  c0;		// correction at lo
+	int32_t  slope;		// 1/256 counts per count, << 16
+};
+
+typedef BasicEncoderCalibration<Encoder> EncoderCalibration;
+
+#endif
@@ -0,0 +1,314 @@
+/* Encoder Library - on-chip hardware quadrature counters
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderCounter_h_
+#define EncoderCounter_h_
+
+#include "Encoder.h"
+
+// Some chips count quadrature in hardware, so edges cost no CPU time at
+// all.  EncoderCounter uses one of these counters with the same read(),
+// write() and readAndReset() as Encoder, chosen per instance:
+//
+//   EncoderCounter fast(0);     // counter unit 0
+//   Encoder knob(5, 6);         // ordinary interrupts
+//   ...
+//   if (!fast.begin(2, 3)) Serial.println("pins can not reach unit 0");
+//
+// Supported so far:
+//
+//   ESP32         PCNT units 0 to 7, any input pin
+//   Teensy 4.x    ENC modules 1 to 4, pins 0-5, 7 and 8 (through XBAR1)
+//
+// The PCNT counter is only 16 bits.  Each read() adds the change since
+// the last one to a 32 bit position, so read() or poll() must be called
+// before the counter moves 16000 counts, for example 160 times per
+// second at 2.5 million counts per second.  ENC has 32 bits, so reads
+// are only needed when the position is wanted.
+//
+// write() and readAndReset() change a software offset, the hardware
+// counts on undisturbed, so no count is ever lost.  Counts have the same
+// direction as Encoder with the same wiring.
+//
+// Each counter talks to its registers through a Hal class.  The real
+// ones write the chip's registers; extras/linux/counter_mock.cpp gives
+// register level models, so everything except the Hal runs on a PC.
+//
+// SAMD21 timers have no quadrature mode.  SAMD51's PDEC does, and could
+// be added as another counter class the same way.
+
+template <class Counter>
+class BasicEncoderCounter
+{
+public:
+	typedef int32_t count_t;
+	BasicEncoderCounter(uint8_t unit) : counter(unit), position(0), offset(0), last(0) { }
+	// false if this unit can not use these pins
+	bool begin(uint8_t pin1, uint8_t pin2) {
+		if (!counter.begin(pin1, pin2)) return false;
+		last = counter.raw();
+		position = 0;
+		offset = 0;
+		return true;
+	}
+	inline count_t read() {
+		noInterrupts();
+		update();
+		count_t ret = (count_t)(position + offset);
+		interrupts();
+		return ret;
+	}
+	inline count_t readAndReset() {
+		noInterrupts();
+		update();
+		count_t ret = (count_t)(position + offset);
+		offset = 0 - position;
+		interrupts();
+		return ret;
+	}
+	inline void write(count_t p) {
+		noInterrupts();
+		update();
+		offset = (uint32_t)p - position;
+		interrupts();
+	}
+	// keep the 32 bit position current, from a timer if read() is rare
+	inline void poll() {
+		noInterrupts();
+		update();
+		interrupts();
+	}
+	Counter counter;
+private:
+	// A 16 bit counter's change is only known modulo its range, so the
+	// change nearest to zero is taken.  32 bit counters wrap like the
+	// position, modulus 0.
+	void update() {
+		uint32_t now = counter.raw();
+		int32_t d = (int32_t)(now - last);
+		last = now;
+		if (Counter::modulus) {
+			const int32_t m = Counter::modulus;
+			d %= m;
+			if (d > m / 2) d -= m;
+			else if (d < -(m / 2)) d += m;
+		}
+		position += (uint32_t)d;
+	}
+	uint32_t position;
+	uint32_t offset;
+	uint32_t last;
+};
+
+
+// ESP32 pulse counter (PCNT).  Channel 0 counts A edges and channel 1
+// counts B edges, each reversed by the level of the other pin, which is
+// full x4 decoding.  The counter goes back to 0 when it reaches either
+// limit, so it counts modulo ENCODER_PCNT_LIMIT.
+#define ENCODER_PCNT_LIMIT	32767
+#define ENCODER_PCNT_UNITS	8
+// register offsets, ESP32 Technical Reference Manual chapter 17
+#define ENCODER_PCNT_CONF0(u)	(0x00 + (u) * 12)
+#define ENCODER_PCNT_CONF1(u)	(0x04 + (u) * 12)
+#define ENCODER_PCNT_CONF2(u)	(0x08 + (u) * 12)
+#define ENCODER_PCNT_CNT(u)	(0x60 + (u) * 4)
+#define ENCODER_PCNT_CTRL	0xB0
+// CONF0 fields: edge actions 0 = none, 1 = increment, 2 = decrement,
+// control actions 0 = keep, 1 = reverse, 2 = hold
+#define ENCODER_PCNT_FILTER_EN	0x400
+#define ENCODER_PCNT_CH0(neg, pos, hctrl, lctrl) \
+	(((uint32_t)(neg) << 16) | ((uint32_t)(pos) << 18) | ((uint32_t)(hctrl) << 20) | ((uint32_t)(lctrl) << 22))
+#define ENCODER_PCNT_CH1(neg, pos, hctrl, lctrl) (ENCODER_PCNT_CH0(neg, pos, hctrl, lctrl) << 8)
+
+template <class Hal>
+class EncoderPcnt
+{
+public:
+	static const uint32_t modulus = ENCODER_PCNT_LIMIT;
+	EncoderPcnt(uint8_t unit) : u(unit), filter(0) { }
+	// ignore pulses shorter than this many 80 MHz clocks, 0 to 1023,
+	// before begin()
+	void setFilter(uint16_t apbCycles) { filter = (apbCycles > 1023) ? 1023 : apbCycles; }
+	bool begin(uint8_t pin1, uint8_t pin2) {
+		if (u >= ENCODER_PCNT_UNITS) return false;
+		Hal::enable();
+		// pause and reset while configuring
+		Hal::write(ENCODER_PCNT_CTRL, Hal::read(ENCODER_PCNT_CTRL) | (3u << (u * 2)));
+		// A rising with B high, or falling with B low: +1
+		// B rising with A low, or falling with A high: +1
+		Hal::write(ENCODER_PCNT_CONF0(u), ENCODER_PCNT_CH0(1, 2, 1, 0)
+			| ENCODER_PCNT_CH1(2, 1, 1, 0)
+			| (filter ? (ENCODER_PCNT_FILTER_EN | filter) : 0));
+		Hal::write(ENCODER_PCNT_CONF1(u), 0);
+		Hal::write(ENCODER_PCNT_CONF2(u), (uint16_t)ENCODER_PCNT_LIMIT
+			| ((uint32_t)(uint16_t)-ENCODER_PCNT_LIMIT << 16));
+		Hal::input(pin1);
+		Hal::input(pin2);
+		Hal::route(pin1, signal(0));	// channel 0 signal
+		Hal::route(pin2, signal(2));	// channel 0 control
+		Hal::route(pin2, signal(1));	// channel 1 signal
+		Hal::route(pin1, signal(3));	// channel 1 control
+		Hal::write(ENCODER_PCNT_CTRL, Hal::read(ENCODER_PCNT_CTRL) & ~(3u << (u * 2)));
+		return true;
+	}
+	// the counter, sign extended
+	inline uint32_t raw() {
+		return (uint32_t)(int32_t)(int16_t)(Hal::read(ENCODER_PCNT_CNT(u)) & 0xFFFF);
+	}
+private:
+	// GPIO matrix input signal numbers, in the order sig ch0, sig ch1,
+	// ctrl ch0, ctrl ch1 for each unit
+	uint8_t signal(uint8_t which) const {
+		return ((u < 5) ? 39 + u * 4 : 71 + (u - 5) * 4) + which;
+	}
+	uint8_t u;
+	uint16_t filter;
+};
+
+
+// i.MX RT quadrature decoder (ENC).  Pins reach it through the XBAR1
+// crossbar, so only pins with an XBAR input work.
+// register offsets, i.MX RT1060 Reference Manual chapter 56
+#define ENCODER_ENC_CTRL	0x00
+#define ENCODER_ENC_FILT	0x02
+#define ENCODER_ENC_UPOS	0x0E
+#define ENCODER_ENC_LPOSH	0x14
+#define ENCODER_ENC_UINIT	0x16
+#define ENCODER_ENC_LINIT	0x18
+#define ENCODER_ENC_CTRL2	0x1E
+#define ENCODER_ENC_CTRL_SWIP	0x0800	// load UINIT/LINIT into the position
+#define ENCODER_ENC_CTRL_REV	0x0400	// count the other direction
+
+template <class Hal>
+class EncoderImxEnc
+{
+public:
+	static const uint32_t modulus = 0;
+	EncoderImxEnc(uint8_t module) : n(module), filter(0) { }
+	// FILT register: sample count (bits 10-8) and period (bits 7-0),
+	// see the reference manual.  Before begin().
+	void setFilter(uint16_t filt) { filter = filt; }
+	bool begin(uint8_t pin1, uint8_t pin2) {
+		if (n < 1 || n > 4) return false;
+		Hal::enable(n);
+		// XBAR1 outputs to ENCn: phase A, phase B, index, home, trigger
+		uint8_t out = 66 + (n - 1) * 5;
+		if (!Hal::route(pin1, out) || !Hal::route(pin2, out + 1)) return false;
+		Hal::write16(n, ENCODER_ENC_CTRL, 0);
+		Hal::write16(n, ENCODER_ENC_CTRL2, 0);
+		Hal::write16(n, ENCODER_ENC_FILT, filter);
+		Hal::write16(n, ENCODER_ENC_UINIT, 0);
+		Hal::write16(n, ENCODER_ENC_LINIT, 0);
+		// ENC counts up when phase A leads, Encoder when pin2 leads
+		Hal::write16(n, ENCODER_ENC_CTRL, ENCODER_ENC_CTRL_REV | ENCODER_ENC_CTRL_SWIP);
+		return true;
+	}
+	// reading UPOS latches the lower half into LPOSH
+	inline uint32_t raw() {
+		uint32_t upper = Hal::read16(n, ENCODER_ENC_UPOS);
+		return (upper << 16) | Hal::read16(n, ENCODER_ENC_LPOSH);
+	}
+private:
+	uint8_t n;
+	uint16_t filter;
+};
+
+
+#if defined(ESP32) && (!defined(CONFIG_IDF_TARGET) || defined(CONFIG_IDF_TARGET_ESP32))
+#include "soc/dport_reg.h"
+
+struct EncoderPcntHal {
+	static uint32_t read(uint32_t offset) {
+		return *(volatile uint32_t *)(DR_REG_PCNT_BASE + offset);
+	}
+	static void write(uint32_t offset, uint32_t value) {
+		*(volatile uint32_t *)(DR_REG_PCNT_BASE + offset) = value;
+	}
+	static void enable() {
+		DPORT_SET_PERI_REG_MASK(DPORT_PERIP_CLK_EN_REG, DPORT_PCNT_CLK_EN);
+		DPORT_CLEAR_PERI_REG_MASK(DPORT_PERIP_RST_EN_REG, DPORT_PCNT_RST);
+	}
+	static void input(uint8_t pin) { pinMode(pin, INPUT_PULLUP); }
+	static void route(uint8_t pin, uint8_t signal) { pinMatrixInAttach(pin, signal, false); }
+};
+typedef BasicEncoderCounter<EncoderPcnt<EncoderPcntHal> > EncoderCounter;
+
+#elif defined(__IMXRT1062__)
+
+struct EncoderImxEncHal {
+	static volatile uint16_t & reg(uint8_t n, uint32_t offset) {
+		return *(volatile uint16_t *)(0x403C8000 + (n - 1) * 0x4000 + offset);
+	}
+	static uint16_t read16(uint8_t n, uint32_t offset) { return reg(n, offset); }
+	static void write16(uint8_t n, uint32_t offset, uint16_t value) { reg(n, offset) = value; }
+	static void enable(uint8_t n) {
+		CCM_CCGR2 |= CCM_CCGR2_XBAR1(CCM_CCGR_ON);
+		switch (n) {
+			case 1: CCM_CCGR4 |= CCM_CCGR4_ENC1(CCM_CCGR_ON); break;
+			case 2: CCM_CCGR4 |= CCM_CCGR4_ENC2(CCM_CCGR_ON); break;
+			case 3: CCM_CCGR4 |= CCM_CCGR4_ENC3(CCM_CCGR_ON); break;
+			case 4: CCM_CCGR4 |= CCM_CCGR4_ENC4(CCM_CCGR_ON); break;
+		}
+	}
+	// pin to XBAR1 input, then XBAR1 input to output
+	static bool route(uint8_t pin, uint8_t output) {
+		struct xbar_pin {
+			uint8_t pin, alt, input;
+			volatile uint32_t *select;
+			uint8_t select_value;
+		};
+		static const xbar_pin pins[] = {
+			{0, 1, 17, &IOMUXC_XBAR1_IN17_SELECT_INPUT, 1},
+			{1, 1, 16, &IOMUXC_XBAR1_IN16_SELECT_INPUT, 0},
+			{2, 3, 6, &IOMUXC_XBAR1_IN06_SELECT_INPUT, 0},
+			{3, 3, 7, &IOMUXC_XBAR1_IN07_SELECT_INPUT, 0},
+			{4, 3, 8, &IOMUXC_XBAR1_IN08_SELECT_INPUT, 0},
+			{5, 3, 17, &IOMUXC_XBAR1_IN17_SELECT_INPUT, 0},
+			{7, 1, 15, &IOMUXC_XBAR1_IN15_SELECT_INPUT, 1},
+			{8, 1, 14, &IOMUXC_XBAR1_IN14_SELECT_INPUT, 1},
+		};
+		for (unsigned i=0; i < sizeof(pins) / sizeof(pins[0]); i++) {
+			if (pins[i].pin != pin) continue;
+			*portControlRegister(pin) = IOMUXC_PAD_PKE | IOMUXC_PAD_PUE
+				| IOMUXC_PAD_PUS(3) | IOMUXC_PAD_HYS;
+			*portConfigRegister(pin) = pins[i].alt;
+			*pins[i].select = pins[i].select_value;
+			uint8_t in = pins[i].input;
+			// XBAR1_INOUT04 to 19 must be set as inputs
+			if (in >= 4 && in <= 19) IOMUXC_GPR_GPR6 &= ~(1 << (in + 12));
+			volatile uint16_t *sel = &XBARA1_SEL0 + output / 2;
+			if (output & 1) {
+				*sel = (*sel & 0x00FF) | ((uint16_t)in << 8);
+			} else {
+				*sel = (*sel & 0xFF00) | in;
+			}
+			return true;
+		}
+		return false;
+	}
+};
+typedef BasicEncoderCounter<EncoderImxEnc<EncoderImxEncHal> > EncoderCounter;
+
+#endif
+
+#endif
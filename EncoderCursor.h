@@ -0,0 +1,86 @@
+/* Encoder Library - independent delta cursors
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderCursor_h_
+#define EncoderCursor_h_
+
+#include "Encoder.h"
+
+// EncoderCursor gives "movement since I last looked" without resetting
+// the Encoder.  readAndReset() zeroes the shared position, so only one
+// part of a program can use it.  Any number of cursors can follow the
+// same Encoder, each remembering only the count it saw last time.
+//
+//   #define ENCODER_MOVEMENT            // before #include <Encoder.h>
+//   EncoderCursor logCursor(myEnc);
+//   EncoderCursor pidCursor(myEnc);
+//   ...
+//   long moved = pidCursor.delta();   // logCursor is not affected
+//
+// Cursors follow the Encoder's movement(), a counter which only
+// counting changes, not the position.  write() and readAndReset(), for
+// example when homing, move the position but not the cursors, so one
+// part of a program can set the position without the others seeing a
+// false jump.  Use ENCODER_MOVEMENT for plain Encoder, or
+// BasicEncoderCursor with any BasicEncoder which has movement in its
+// traits.
+//
+// Each call is 1 movement() of the Encoder, which is atomic like
+// read(), and a subtract.  The subtract wraps the same way the counter
+// does, so the delta stays correct when it rolls over, as long as each
+// cursor is read before it falls more than half the counter's range
+// behind (32767 counts for 16 bit, 2^31 for 32 bit).
+
+template <class EncoderType>
+class BasicEncoderCursor
+{
+public:
+	typedef typename EncoderType::count_t count_t;
+	BasicEncoderCursor(EncoderType &enc) : encoder(enc) { sync(); }
+	// movement since the previous delta() or sync()
+	inline count_t delta() {
+		count_t now = encoder.movement();
+		count_t ret = difference(now, last);
+		last = now;
+		return ret;
+	}
+	// movement since the previous delta() or sync(), without consuming it
+	inline count_t peek() {
+		return difference(encoder.movement(), last);
+	}
+	// start counting from now, forgetting any movement not yet seen
+	inline void sync() {
+		last = encoder.movement();
+	}
+private:
+	// unsigned math, so wrapping around is well defined
+	static inline count_t difference(count_t a, count_t b) {
+		return (count_t)((uint32_t)a - (uint32_t)b);
+	}
+	EncoderType &encoder;
+	count_t last;
+};
+
+typedef BasicEncoderCursor<Encoder> EncoderCursor;
+
+#endif
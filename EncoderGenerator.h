@@ -0,0 +1,241 @@
+/* Encoder Library - quadrature signal generator for testing
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderGenerator_h_
+#define EncoderGenerator_h_
+
+// The generator itself has no Arduino dependencies, so the same
+// reproducible signals can drive a simulation on a PC, or output pins
+// wired back to an Encoder's inputs (EncoderSignalOutput, below).
+#include <stdint.h>
+
+// EncoderSignalGenerator produces the edges of a quadrature signal, in
+// time order, with nanosecond timestamps.  Everything random comes from
+// a seeded generator, so the same settings and seed always give exactly
+// the same edges.
+//
+//   setSweep()       count rate, changing linearly from start to end.
+//                    Negative rates count down.  Rate is edges/sec, which
+//                    is also counts/sec: 4 per cycle of either signal.
+//   setPhaseError()  B edges late (or early, if negative) by a fraction
+//                    of the step time, so the spacing is uneven.  Near
+//                    +/-1 the A and B edges nearly coincide.  Edges are
+//                    never out of order.
+//   setJitter()      random +/- nanoseconds on every edge.
+//   setBounce()      chance of extra toggles after an edge, like a
+//                    mechanical contact.  The line ends at its new level.
+//   setMissRate()    chance that an edge is late, arriving at the same
+//                    time as the next one, so a decoder sees 2 steps at
+//                    once, as if it had missed an edge.
+//
+// position() is the true position: every step taken, including missed
+// ones.  Compare it with Encoder's count.
+
+struct EncoderSignalEdge {
+	uint64_t ns;		// time since the start
+	uint8_t  pin;		// 0 = A (Encoder's pin1), 1 = B (pin2)
+	uint8_t  level;
+};
+
+#define ENCODER_GENERATOR_MAX_BOUNCE	4
+
+class EncoderSignalGenerator
+{
+public:
+	EncoderSignalGenerator() {
+		setSweep(1000, 1000, 1000000);
+		phase_error = 0;
+		jitter = 0;
+		bounce_chance = 0;
+		bounce_count = 0;
+		bounce_ns = 0;
+		miss_chance = 0;
+		seed(1);
+	}
+	// counts/sec at the start and end, over duration microseconds
+	void setSweep(float startRate, float endRate, uint32_t durationMicros) {
+		rate_start = startRate;
+		rate_end = endRate;
+		duration = (uint64_t)durationMicros * 1000;
+	}
+	void setPhaseError(float fraction) { phase_error = fraction; }
+	void setJitter(uint32_t nanoseconds) { jitter = nanoseconds; }
+	// chance 0 to 1 that an edge bounces count times, within nanoseconds
+	void setBounce(float chance, uint8_t count, uint32_t nanoseconds) {
+		bounce_chance = chance_to_fixed(chance);
+		bounce_count = (count <= ENCODER_GENERATOR_MAX_BOUNCE) ? count : ENCODER_GENERATOR_MAX_BOUNCE;
+		bounce_ns = nanoseconds;
+	}
+	void setMissRate(float chance) { miss_chance = chance_to_fixed(chance); }
+	// restart from time 0, both signals low
+	void seed(uint32_t s) {
+		random_state = s ? s : 1;
+		now = 0;
+		last_ns = 0;
+		step = 0;
+		position_now = 0;
+		levels[0] = levels[1] = 0;
+		missed = 0;
+		late = false;
+		head = tail = 0;
+	}
+
+	// the next edge, false when the sweep has finished
+	bool next(EncoderSignalEdge &edge) {
+		while (head == tail) {
+			if (!generate()) return false;
+		}
+		edge = queue[tail];
+		tail = (tail + 1) % queue_size;
+		return true;
+	}
+	int32_t position() const { return position_now; }
+	uint32_t missedEdges() const { return missed; }
+	uint8_t level(uint8_t pin) const { return levels[pin]; }
+
+private:
+	// one step of the signal, with its bounces, into the queue
+	bool generate() {
+		if (now >= duration) {
+			if (!late) return false;
+			push(last_ns + 1, late_pin, levels[late_pin]);
+			late = false;
+			return true;
+		}
+		float r = rate_start + (rate_end - rate_start) * ((float)now / (float)duration);
+		if (r > -1.0f && r < 1.0f) r = (rate_end >= rate_start) ? 1.0f : -1.0f;
+		float period = 1e9f / ((r > 0) ? r : -r);
+		now += (uint64_t)period;
+		int8_t dir = (r > 0) ? 1 : -1;
+		step = (step + dir) & 3;
+		position_now += dir;
+		// Encoder counts up for this order of (pin1, pin2)
+		static const uint8_t seq[4][2] = {{0,0}, {0,1}, {1,1}, {1,0}};
+		uint8_t pin = (seq[step][0] != levels[0]) ? 0 : 1;
+		levels[pin] = seq[step][pin];
+		if (!late && chance(miss_chance)) {
+			// held back, to be sent with the next edge
+			late = true;
+			late_pin = pin;
+			missed++;
+			return true;
+		}
+		int64_t t = now;
+		if (pin == 1) t += (int64_t)(phase_error * period);
+		if (jitter) t += (int64_t)(random() % (2 * jitter + 1)) - jitter;
+		if (t <= (int64_t)last_ns) t = last_ns + 1;
+		if (late) {
+			push(t, late_pin, levels[late_pin]);
+			late = false;
+		}
+		push(t, pin, levels[pin]);
+		if (bounce_count && chance(bounce_chance)) {
+			// bounces fit in the given time, and in half a step
+			uint64_t width = bounce_ns;
+			if (width > (uint64_t)(period / 2)) width = period / 2;
+			uint64_t gap = width / (2 * bounce_count);
+			if (gap == 0) gap = 1;
+			for (uint8_t i=0; i < bounce_count; i++) {
+				push(last_ns + gap, pin, !levels[pin]);
+				push(last_ns + gap, pin, levels[pin]);
+			}
+		}
+		return true;
+	}
+	void push(uint64_t ns, uint8_t pin, uint8_t level) {
+		queue[head].ns = ns;
+		queue[head].pin = pin;
+		queue[head].level = level;
+		head = (head + 1) % queue_size;
+		last_ns = ns;
+	}
+	// xorshift32
+	uint32_t random() {
+		uint32_t x = random_state;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		random_state = x;
+		return x;
+	}
+	static uint32_t chance_to_fixed(float c) {
+		if (c <= 0) return 0;
+		if (c >= 1.0f) return 0xFFFFFFFF;
+		return (uint32_t)(c * 4294967295.0f);
+	}
+	bool chance(uint32_t c) { return c && random() <= c; }
+
+	static const uint8_t queue_size = 2 * ENCODER_GENERATOR_MAX_BOUNCE + 3;
+	float rate_start, rate_end, phase_error;
+	uint64_t duration, now, last_ns;
+	uint32_t jitter, bounce_chance, bounce_ns, miss_chance;
+	uint8_t bounce_count;
+	uint32_t random_state;
+	uint8_t step;
+	uint8_t levels[2];
+	int32_t position_now;
+	uint32_t missed;
+	bool late;
+	uint8_t late_pin;
+	EncoderSignalEdge queue[queue_size];
+	uint8_t head, tail;
+};
+
+#if defined(ARDUINO)
+// Plays a generator's edges on 2 output pins in real time, for loopback
+// testing.  Call update() as often as possible, from loop() or a fast
+// timer.  Edges which are already late are written immediately, so
+// the signal is only as accurate as update() is frequent.
+class EncoderSignalOutput
+{
+public:
+	void begin(EncoderSignalGenerator &gen, uint8_t pinA, uint8_t pinB) {
+		generator = &gen;
+		pins[0] = pinA;
+		pins[1] = pinB;
+		pinMode(pinA, OUTPUT);
+		pinMode(pinB, OUTPUT);
+		digitalWrite(pinA, LOW);
+		digitalWrite(pinB, LOW);
+		start = micros();
+		pending = generator->next(edge);
+	}
+	// returns false after the last edge
+	bool update() {
+		uint32_t elapsed = micros() - start;
+		while (pending && (uint32_t)(edge.ns / 1000) <= elapsed) {
+			digitalWrite(pins[edge.pin], edge.level);
+			pending = generator->next(edge);
+		}
+		return pending;
+	}
+private:
+	EncoderSignalGenerator *generator;
+	uint8_t pins[2];
+	uint32_t start;
+	EncoderSignalEdge edge;
+	bool pending;
+};
+#endif
+
+#endif
@@ -0,0 +1,201 @@
+/* Encoder Library - 3 channel Hall sensor decoder
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderHall_h_
+#define EncoderHall_h_
+
+#include "Encoder.h"
+
+// EncoderHall decodes the 3 Hall sensors of a brushless (BLDC) motor,
+// using the same interrupts and update() design as Encoder.  Each
+// sensor change moves 1 commutation sector, so the position counts 6
+// per electrical revolution (6 * pole pairs per shaft revolution).
+//
+//   EncoderHall motor(5, 6, 7);      // sensors A, B, C
+//   long pos = motor.read();
+//   uint8_t s = motor.sector();      // 0 to 5, for commutation
+//
+// Valid sensor codes (C B A) follow 001, 011, 010, 110, 100, 101, which
+// are sectors 0 to 5.  Moving forward through that list counts up.
+// Codes 000 and 111 are impossible with working sensors, and so is a
+// jump of 3 sectors, which has no known direction.  Those are counted
+// by invalid() and do not change the position.  A jump of 2 sectors
+// (a missed edge) counts 2 in the direction of the shorter way.
+//
+// All 3 pins should have interrupts.  Pins without them are only
+// updated when read() is called, like Encoder.
+
+// sector for each sensor code, 255 for the impossible codes
+#define ENCODER_HALL_NO_SECTOR	255
+// table entry for an impossible change
+#define ENCODER_HALL_INVALID	-128
+
+template <typename count_t>
+struct Encoder_hall_state {
+	volatile IO_REG_TYPE * pin_register[3];
+	IO_REG_TYPE            pin_bitmask[3];
+	uint8_t                state;		// sensor code, C B A
+	count_t                position;
+	uint32_t               invalid;
+};
+
+template <class Traits>
+class BasicEncoderHall : public EncoderDispatch<Encoder_hall_state<typename Traits::count_t>,
+	BasicEncoderHall<Traits> >
+{
+public:
+	typedef typename Traits::count_t count_t;
+	typedef Encoder_hall_state<count_t> state_t;
+private:
+	typedef EncoderDispatch<state_t, BasicEncoderHall<Traits> > dispatch;
+#if !defined(ENCODER_USE_INTERRUPTS)
+	static_assert(Traits::interrupts == ENCODER_POLLED,
+		"ENCODER_DO_NOT_USE_INTERRUPTS allows only ENCODER_POLLED");
+#elif defined(ENCODER_OPTIMIZE_INTERRUPTS)
+	static_assert(Traits::interrupts == ENCODER_POLLED,
+		"ENCODER_OPTIMIZE_INTERRUPTS vectors are used by Encoder, use ENCODER_POLLED");
+#endif
+public:
+	BasicEncoderHall(uint8_t pinA, uint8_t pinB, uint8_t pinC) { begin(pinA, pinB, pinC); }
+	BasicEncoderHall() { }
+	void begin(uint8_t pinA, uint8_t pinB, uint8_t pinC) {
+		const uint8_t pin[3] = {pinA, pinB, pinC};
+		for (uint8_t i=0; i < 3; i++) {
+			#ifdef INPUT_PULLUP
+			pinMode(pin[i], INPUT_PULLUP);
+			#else
+			pinMode(pin[i], INPUT);
+			digitalWrite(pin[i], HIGH);
+			#endif
+			hall.pin_register[i] = PIN_TO_BASEREG(pin[i]);
+			hall.pin_bitmask[i] = PIN_TO_BITMASK(pin[i]);
+		}
+		hall.position = 0;
+		hall.invalid = 0;
+		// Hall sensors have push-pull or pullup outputs, but allow
+		// for an R-C filter like Encoder does
+		EncoderStartup::settle(ENCODER_SETTLE_MICROSECONDS);
+		hall.state = sensors(&hall);
+		interrupts_in_use = 0;
+		if (Traits::interrupts != ENCODER_POLLED) {
+			for (uint8_t i=0; i < 3; i++) {
+				interrupts_in_use += dispatch::attach_interrupt(pin[i], &hall);
+			}
+		}
+	}
+	inline count_t read() {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&hall);
+			return hall.position;
+		}
+		noInterrupts();
+		if (interrupts_in_use < 3) update(&hall);
+		count_t ret = hall.position;
+		interrupts();
+		return ret;
+	}
+	inline void write(count_t p) {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			hall.position = p;
+			return;
+		}
+		noInterrupts();
+		hall.position = p;
+		interrupts();
+	}
+	// commutation sector 0 to 5, or ENCODER_HALL_NO_SECTOR
+	inline uint8_t sector() {
+		if (Traits::interrupts == ENCODER_POLLED || interrupts_in_use < 3) read();
+		return sector_of(hall.state);
+	}
+	// number of impossible sensor codes or changes seen
+	inline uint32_t invalid() {
+		if (Traits::interrupts == ENCODER_POLLED) {
+			update(&hall);
+			return hall.invalid;
+		}
+		noInterrupts();
+		if (interrupts_in_use < 3) update(&hall);
+		uint32_t ret = hall.invalid;
+		interrupts();
+		return ret;
+	}
+private:
+	state_t hall;
+	uint8_t interrupts_in_use;
+
+	static inline uint8_t sensors(state_t *arg) {
+		uint8_t s = 0;
+		if (DIRECT_PIN_READ(arg->pin_register[0], arg->pin_bitmask[0])) s |= 1;
+		if (DIRECT_PIN_READ(arg->pin_register[1], arg->pin_bitmask[1])) s |= 2;
+		if (DIRECT_PIN_READ(arg->pin_register[2], arg->pin_bitmask[2])) s |= 4;
+		return s;
+	}
+	static inline uint8_t sector_of(uint8_t code) {
+		static const uint8_t table[8] = {
+			ENCODER_HALL_NO_SECTOR, 0, 2, 1, 4, 5, 3, ENCODER_HALL_NO_SECTOR
+		};
+		return table[code];
+	}
+public:
+	//	new code (C B A) across, old code down
+	//	      000 001 010 011 100 101 110 111
+	//	000    0   0   0   0   0   0   0   X	leaving an impossible
+	//	001    X   0  +2  +1  -2  -1   X   X	code only resyncs
+	//	010    X  -2   0  -1  +2   X  +1   X
+	//	011    X  -1  +1   0   X  -2  +2   X	X = ENCODER_HALL_INVALID
+	//	100    X  +2  -2   X   0  +1  -1   X
+	//	101    X  +1   X  +2  -1   0  -2   X
+	//	110    X   X  -1  -2  +1  +2   0   X
+	//	111    X   0   0   0   0   0   0   0
+	//
+	// update() is public for the interrupt routines, do not call it.
+#if defined(IRAM_ATTR)
+	static IRAM_ATTR void update(state_t *arg) {
+#else
+	static void update(state_t *arg) {
+#endif
+		static const int8_t table[64] = {
+			0, 0, 0, 0, 0, 0, 0, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, 0, 2, 1, -2, -1, ENCODER_HALL_INVALID, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, -2, 0, -1, 2, ENCODER_HALL_INVALID, 1, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, -1, 1, 0, ENCODER_HALL_INVALID, -2, 2, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, 2, -2, ENCODER_HALL_INVALID, 0, 1, -1, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, 1, ENCODER_HALL_INVALID, 2, -1, 0, -2, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, ENCODER_HALL_INVALID, -1, -2, 1, 2, 0, ENCODER_HALL_INVALID,
+			ENCODER_HALL_INVALID, 0, 0, 0, 0, 0, 0, 0
+		};
+		uint8_t code = sensors(arg);
+		int8_t d = table[(arg->state << 3) | code];
+		arg->state = code;
+		if (d == ENCODER_HALL_INVALID) {
+			arg->invalid++;
+		} else {
+			arg->position += d;
+		}
+	}
+};
+
+typedef BasicEncoderHall<EncoderDefaultTraits> EncoderHall;
+
+#endif
@@ -0,0 +1,149 @@
+/* Encoder Library - position history, queryable by time
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderHistory_h_
+#define EncoderHistory_h_
+
+#include "Encoder.h"
+
+// EncoderHistory answers "where was the encoder at time t?", for example
+// when a camera was triggered 3 ms ago.  It keeps a ring of (micros(),
+// position) entries, written either
+//
+//   - by the interrupt at every count, with #define ENCODER_HISTORY
+//     (or Traits::history) and myEnc.setHistory(&history), or
+//   - at a fixed rate, by calling history.sample(myEnc) from a timer.
+//
+// Every count gives the most detail, but a fast encoder fills the ring
+// quickly, so it only reaches a short time back.  Fixed rate sampling
+// reaches back size / rate seconds at any speed.  Each entry is 8 bytes,
+// so EncoderHistory<64> uses 512 bytes of RAM.  The size must be a
+// power of 2.
+//
+// positionAt() finds the 2 entries around the requested time with a
+// binary search, O(log size), and interpolates between them.  Between
+// counts the real position is somewhere within 1 count, so the result
+// is a good estimate of where a moving shaft was.  After the newest
+// entry it is the newest position, before the oldest there is no
+// answer.  Times are micros() values, which wrap after 71 minutes, so
+// the ring must not span more than half of that.
+//
+// With setHistory(), write() and readAndReset() on the Encoder record a
+// step, the old and new position at the same time, so positionAt()
+// gives the old position before the write and the new one after, never
+// a ramp between them.  sample() does not see writes: a write between
+// 2 samples looks like movement between them, so call clear() after
+// write() if that matters.
+//
+//   EncoderHistory<128> history;
+//   myEnc.setHistory(&history);       // after begin()
+//   ...
+//   float where;
+//   if (history.positionAt(triggerTime, where)) ...
+
+class EncoderHistoryBuffer : public Encoder_history_t
+{
+public:
+	// record the present position, for fixed rate history
+	template <class EncoderType>
+	void sample(EncoderType &enc) {
+		int32_t p = enc.read();
+		uint32_t t = micros();
+		noInterrupts();
+		encoder_history_record(this, t, p);
+		interrupts();
+	}
+	// false if the time is before the oldest entry, or nothing recorded
+	bool positionAt(uint32_t time, float &position) {
+		Encoder_history_entry_t a, b;
+		noInterrupts();
+		uint16_t n = used;
+		if (n == 0) {
+			interrupts();
+			return false;
+		}
+		uint16_t oldest = head - n;
+		uint32_t base = entries[oldest & mask].time;
+		uint32_t offset = time - base;
+		b = entries[(uint16_t)(head - 1) & mask];
+		if (offset >= b.time - base) {
+			interrupts();
+			// after the newest entry, or long before the oldest
+			if (offset >= 0x80000000) return false;
+			position = b.position;
+			return true;
+		}
+		// last entry at or before time, entries lo to hi are in order
+		uint16_t lo = 0, hi = n - 1;
+		while (hi - lo > 1) {
+			uint16_t mid = lo + (hi - lo) / 2;
+			if (entries[(uint16_t)(oldest + mid) & mask].time - base <= offset) {
+				lo = mid;
+			} else {
+				hi = mid;
+			}
+		}
+		a = entries[(uint16_t)(oldest + lo) & mask];
+		b = entries[(uint16_t)(oldest + hi) & mask];
+		interrupts();
+		uint32_t span = b.time - a.time;
+		int32_t change = (int32_t)((uint32_t)b.position - (uint32_t)a.position);
+		position = a.position;
+		if (span) position += (float)change * (float)(time - a.time) / (float)span;
+		return true;
+	}
+	// number of entries, and the time of the oldest
+	uint16_t count() { return used; }
+	uint32_t oldest() {
+		noInterrupts();
+		uint32_t t = entries[(uint16_t)(head - used) & mask].time;
+		interrupts();
+		return t;
+	}
+	void clear() {
+		noInterrupts();
+		head = 0;
+		used = 0;
+		interrupts();
+	}
+protected:
+	EncoderHistoryBuffer(Encoder_history_entry_t *storage, uint16_t size) {
+		entries = storage;
+		mask = size - 1;
+		head = 0;
+		used = 0;
+	}
+};
+
+template <uint16_t size>
+class EncoderHistory : public EncoderHistoryBuffer
+{
+	static_assert(size >= 2 && (size & (size - 1)) == 0,
+		"EncoderHistory size must be a power of 2");
+public:
+	EncoderHistory() : EncoderHistoryBuffer(storage, size) { }
+private:
+	Encoder_history_entry_t storage[size];
+};
+
+#endif
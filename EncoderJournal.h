@@ -0,0 +1,408 @@
+/* Encoder Library - position journal for power loss recovery
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderJournal_h_
+#define EncoderJournal_h_
+
+#include "Encoder.h"
+
+// EncoderJournal keeps the position in EEPROM or flash, so after a
+// power loss begin() puts it back with write(), without homing again.
+//
+//   EncoderJournalEEPROM store(0, 128, 8);     // 8 sectors of 128 bytes
+//   EncoderJournal journal(myEnc, store);
+//   void setup() {
+//     if (!journal.begin()) home();            // restores with write()
+//   }
+//   void loop() {
+//     journal.update();                        // writes when stopped
+//   }
+//
+// The storage is a ring of sectors, used one at a time, so every sector
+// wears the same.  Each sector starts with a 12 byte header holding the
+// absolute position and a sequence number, then 4 byte records, each
+// holding the change in position since the previous one, which must be
+// within +/- 2^23 counts.  When a sector is full, or the change is too
+// big, the next sector is erased and started with a new header.
+// begin() reads every header to find the newest sector, then adds up
+// its records, so recovery reads at most 1 sector.
+//
+// Writes are what wear out the storage, so update() only writes when
+// the position has not changed for settle milliseconds (the machine
+// stopped), or has moved maxStep counts from the saved position (0 to
+// write only when stopped).  Call flush() from a brownout or power fail
+// interrupt, if there is one, to save the very latest position.  If
+// the interrupt comes while update() is writing, flush() writes nothing
+// and returns false, rather than write into the middle of that record.
+// Then the record being written is kept if power lasts long enough,
+// otherwise the one before it.
+//
+// Power can fail in the middle of a write.  Records and headers end
+// with a CRC which is never 0xFF (0xFFFF for headers), written last,
+// so a partly written one does not pass the check and is skipped.  That
+// loses only the position being written, the one before it is still
+// there.  A new sector is erased before the old one is abandoned, so
+// a failed erase or header leaves the old sector the newest.  This
+// assumes bytes are programmed in order, true of EEPROM and most NOR
+// flash.  With flash which programs a whole word at once, a torn word
+// could pass the 8 bit CRC by chance, 1 in 256.
+//
+// The storage class provides:
+//
+//   uint32_t sectorSize()          bytes per sector, a multiple of 4
+//   uint16_t sectors()             at least 2
+//   void read(uint32_t address, uint8_t *data, uint16_t length)
+//   void program(uint32_t address, const uint8_t *data, uint16_t length)
+//   void erase(uint16_t sector)    all bytes to 0xFF
+//
+// Addresses start at 0 for the first byte of the first sector.  program()
+// is only used on erased bytes.  EncoderJournalEEPROM is included for
+// boards with EEPROM.h, and EncoderJournalFile on Linux, which emulates
+// flash in a file and can cut the power at any byte, for testing.
+
+#define ENCODER_JOURNAL_HEADER	12
+#define ENCODER_JOURNAL_RECORD	4
+
+static inline uint8_t encoder_journal_crc8(uint8_t crc, const uint8_t *data, uint8_t len)
+{
+	while (len--) {
+		crc ^= *data++;
+		for (uint8_t i=0; i < 8; i++) {
+			crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+		}
+	}
+	return (crc == 0xFF) ? 0xFE : crc;
+}
+
+static inline uint16_t encoder_journal_crc16(const uint8_t *data, uint8_t len)
+{
+	uint16_t crc = 0xFFFF;
+	while (len--) {
+		crc ^= (uint16_t)*data++ << 8;
+		for (uint8_t i=0; i < 8; i++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+		}
+	}
+	return (crc == 0xFFFF) ? 0xFFFE : crc;
+}
+
+template <class EncoderType, class Storage>
+class BasicEncoderJournal
+{
+	static_assert(sizeof(typename EncoderType::count_t) == 4,
+		"EncoderJournal needs a 32 bit count");
+public:
+	BasicEncoderJournal(EncoderType &enc, Storage &storage) : encoder(enc), store(storage) {
+		setPolicy(250, 0);
+		sector = 0;
+		seq = 0;
+		next = 0;
+		saved = 0;
+		busy = false;
+		records = 0;
+		erases = 0;
+		skipped = 0;
+	}
+	// write after settle milliseconds without change, or after moving
+	// maxStep counts (0 = only when stopped)
+	void setPolicy(uint32_t settleMillis, uint32_t maxStep) {
+		settle = settleMillis * 1000;
+		step = maxStep;
+	}
+	// Find the newest position and give it to the Encoder with write().
+	// Returns false if the storage held no journal, then it is started
+	// from the Encoder's present position.
+	bool begin() {
+		per_sector = (store.sectorSize() - ENCODER_JOURNAL_HEADER) / ENCODER_JOURNAL_RECORD;
+		bool found = false;
+		uint16_t count = store.sectors();
+		for (uint16_t s=0; s < count; s++) {
+			uint32_t header_seq;
+			int32_t position;
+			if (read_header(s, header_seq, position)
+			  && (!found || (int32_t)(header_seq - seq) > 0)) {
+				found = true;
+				sector = s;
+				seq = header_seq;
+				saved = position;
+			}
+		}
+		if (!found) {
+			sector = count - 1;
+			seq = 0;
+			start_sector(encoder.read());
+			last_seen = saved;
+			changed = micros();
+			return false;
+		}
+		replay();
+		encoder.write(saved);
+		last_seen = saved;
+		changed = micros();
+		return true;
+	}
+	// call often, from loop
+	bool update() {
+		int32_t now = encoder.read();
+		uint32_t t = micros();
+		if (now != last_seen) {
+			last_seen = now;
+			changed = t;
+		}
+		if (now == saved) return false;
+		uint32_t distance = (now > saved) ? (uint32_t)now - saved : (uint32_t)saved - now;
+		if (t - changed < settle && (step == 0 || distance < step)) return false;
+		record(now);
+		return true;
+	}
+	// write the present position now, if it changed, also from an
+	// interrupt which may have stopped update() in the middle of a write
+	bool flush() {
+		if (busy) return false;
+		int32_t now = encoder.read();
+		if (now == saved) return false;
+		record(now);
+		return true;
+	}
+	int32_t savedPosition() const { return saved; }
+	uint32_t records;	// records and headers written
+	uint32_t erases;	// sectors erased
+	uint32_t skipped;	// bad records found by begin(), from power loss
+private:
+	uint32_t address(uint16_t s, uint16_t record) {
+		return (uint32_t)s * store.sectorSize() + ENCODER_JOURNAL_HEADER
+			+ (uint32_t)record * ENCODER_JOURNAL_RECORD;
+	}
+	bool read_header(uint16_t s, uint32_t &header_seq, int32_t &position) {
+		uint8_t h[ENCODER_JOURNAL_HEADER];
+		store.read((uint32_t)s * store.sectorSize(), h, ENCODER_JOURNAL_HEADER);
+		if (h[0] != 'E' || h[1] != 'J') return false;
+		if (encoder_journal_crc16(h, 10) != (h[10] | (h[11] << 8))) return false;
+		header_seq = get32(h + 2);
+		position = (int32_t)get32(h + 6);
+		return true;
+	}
+	// add up the newest sector's records, to the first never written
+	void replay() {
+		uint8_t buf[8 * ENCODER_JOURNAL_RECORD];
+		next = per_sector;
+		for (uint16_t i=0; i < per_sector; i += 8) {
+			uint16_t n = (per_sector - i < 8) ? per_sector - i : 8;
+			store.read(address(sector, i), buf, n * ENCODER_JOURNAL_RECORD);
+			for (uint16_t j=0; j < n; j++) {
+				const uint8_t *r = buf + j * ENCODER_JOURNAL_RECORD;
+				if ((r[0] & r[1] & r[2] & r[3]) == 0xFF) {
+					next = i + j;
+					return;
+				}
+				if (encoder_journal_crc8((uint8_t)seq, r, 3) != r[3]) {
+					skipped++;	// partly written, leave it
+					continue;
+				}
+				// stored inverted, so a change of 0 (never written)
+				// would be the erased value
+				uint32_t v = ~((uint32_t)r[0] | ((uint32_t)r[1] << 8)
+					| ((uint32_t)r[2] << 16)) & 0xFFFFFF;
+				saved += (int32_t)(v << 8) >> 8;
+			}
+		}
+	}
+	void record(int32_t position) {
+		busy = true;
+		int32_t delta = (int32_t)((uint32_t)position - (uint32_t)saved);
+		if (next >= per_sector || delta >= 0x800000 || delta < -0x800000) {
+			start_sector(position);
+			busy = false;
+			return;
+		}
+		uint8_t r[ENCODER_JOURNAL_RECORD];
+		uint32_t v = ~(uint32_t)delta;
+		r[0] = v;
+		r[1] = v >> 8;
+		r[2] = v >> 16;
+		r[3] = encoder_journal_crc8((uint8_t)seq, r, 3);
+		store.program(address(sector, next), r, ENCODER_JOURNAL_RECORD);
+		next++;
+		saved = position;
+		records++;
+		busy = false;
+	}
+	// erase the next (oldest) sector and start it with the position
+	void start_sector(int32_t position) {
+		uint16_t s = sector + 1;
+		if (s >= store.sectors()) s = 0;
+		store.erase(s);
+		erases++;
+		uint8_t h[ENCODER_JOURNAL_HEADER];
+		h[0] = 'E';
+		h[1] = 'J';
+		put32(h + 2, seq + 1);
+		put32(h + 6, (uint32_t)position);
+		uint16_t crc = encoder_journal_crc16(h, 10);
+		h[10] = crc;
+		h[11] = crc >> 8;
+		store.program((uint32_t)s * store.sectorSize(), h, ENCODER_JOURNAL_HEADER);
+		sector = s;
+		seq++;
+		next = 0;
+		saved = position;
+		records++;
+	}
+	static uint32_t get32(const uint8_t *p) {
+		return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16)
+			| ((uint32_t)p[3] << 24);
+	}
+	static void put32(uint8_t *p, uint32_t n) {
+		p[0] = n;
+		p[1] = n >> 8;
+		p[2] = n >> 16;
+		p[3] = n >> 24;
+	}
+	EncoderType &encoder;
+	Storage &store;
+	uint32_t settle;	// microseconds
+	uint32_t step;
+	uint16_t sector;	// newest
+	uint16_t per_sector;	// records which fit after the header
+	uint16_t next;		// next record in sector
+	uint32_t seq;
+	int32_t  saved;		// position in storage
+	int32_t  last_seen;
+	uint32_t changed;	// micros() when last_seen changed
+	volatile bool busy;	// in record(), flush() must not write
+};
+
+#if defined(ENCODER_LINUX_GPIO)
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Flash emulated in a file: erased bytes are 0xFF, and programming can
+// only clear bits, like NOR flash.  cutPowerAfter(n) makes the n-th
+// byte programmed or erased from now only partly change, then ignores
+// everything until powerOn(), like a power loss in the middle.
+class EncoderJournalFile
+{
+public:
+	EncoderJournalFile() : fd(-1), size(0), count(0), budget(-1), dead(false), rng(1) { }
+	~EncoderJournalFile() { close(); }
+	// an existing file keeps its contents, a new one starts erased
+	bool open(const char *path, uint32_t sectorBytes, uint16_t sectorCount) {
+		close();
+		fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (fd < 0) return false;
+		size = sectorBytes;
+		count = sectorCount;
+		uint32_t total = size * count;
+		off_t old = lseek(fd, 0, SEEK_END);
+		uint8_t ff = 0xFF;
+		for (off_t a = (old > 0) ? old : 0; a < (off_t)total; a++) {
+			if (pwrite(fd, &ff, 1, a) != 1) return false;
+		}
+		return true;
+	}
+	void close() {
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+	}
+	uint32_t sectorSize() { return size; }
+	uint16_t sectors() { return count; }
+	void read(uint32_t address, uint8_t *data, uint16_t length) {
+		if (pread(fd, data, length, address) != length) memset(data, 0xFF, length);
+	}
+	void program(uint32_t address, const uint8_t *data, uint16_t length) {
+		for (uint16_t i=0; i < length; i++) {
+			uint8_t b;
+			read(address + i, &b, 1);
+			change(address + i, b, b & data[i]);
+		}
+	}
+	void erase(uint16_t sector) {
+		for (uint32_t i=0; i < size; i++) {
+			uint8_t b;
+			read(sector * size + i, &b, 1);
+			change(sector * size + i, b, 0xFF);
+		}
+	}
+	void cutPowerAfter(int32_t bytes) { budget = bytes; }
+	void powerOn() {
+		budget = -1;
+		dead = false;
+	}
+	bool powerLost() const { return dead; }
+	void seed(uint32_t s) { rng = s ? s : 1; }
+private:
+	void change(uint32_t address, uint8_t from, uint8_t to) {
+		if (dead) return;
+		if (budget >= 0 && budget-- == 0) {
+			// only some of the bits which should change do
+			rng ^= rng << 13;
+			rng ^= rng >> 17;
+			rng ^= rng << 5;
+			to = from ^ ((from ^ to) & (uint8_t)rng);
+			dead = true;
+		}
+		if (pwrite(fd, &to, 1, address) != 1) dead = true;
+	}
+	int fd;
+	uint32_t size;
+	uint16_t count;
+	int32_t budget;
+	bool dead;
+	uint32_t rng;
+};
+
+#elif defined(__AVR__) || defined(TEENSYDUINO)
+#include <EEPROM.h>
+
+// Sectors in EEPROM, from a start address.  EEPROM needs no erase, so
+// erase() writes 0xFF only where a byte is not already 0xFF.  On AVR
+// each byte written takes 3.3 ms, so starting a new 128 byte sector
+// blocks update() for about 0.4 s, and a record takes 13 ms.  flush()
+// in that time writes nothing, see above.
+class EncoderJournalEEPROM
+{
+public:
+	EncoderJournalEEPROM(uint16_t start, uint16_t sectorBytes, uint16_t sectorCount)
+	  : base(start), size(sectorBytes), count(sectorCount) { }
+	uint32_t sectorSize() { return size; }
+	uint16_t sectors() { return count; }
+	void read(uint32_t address, uint8_t *data, uint16_t length) {
+		for (uint16_t i=0; i < length; i++) data[i] = EEPROM.read(base + address + i);
+	}
+	void program(uint32_t address, const uint8_t *data, uint16_t length) {
+		for (uint16_t i=0; i < length; i++) EEPROM.update(base + address + i, data[i]);
+	}
+	void erase(uint16_t sector) {
+		for (uint16_t i=0; i < size; i++) EEPROM.update(base + sector * size + i, 0xFF);
+	}
+private:
+	uint16_t base;
+	uint16_t size;
+	uint16_t count;
+};
+
+typedef BasicEncoderJournal<Encoder, EncoderJournalEEPROM> EncoderJournal;
+#endif
+
+#endif
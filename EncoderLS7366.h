@@ -0,0 +1,189 @@
+/* Encoder Library - LS7366R quadrature counter chips over SPI
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderLS7366_h_
+#define EncoderLS7366_h_
+
+#include "Encoder.h"
+#include "utility/encoder_channel.h"
+
+// Above a few MHz of edges no interrupt can keep up, but a counter chip
+// like the LS7366R counts up to 40 MHz by itself.  EncoderLS7366 reads
+// any number of them through SPI, with the same read(), write() and
+// readAndReset() as Encoder, one set per chip.
+//
+//   const uint8_t selects[] = {7, 8, 9};          // CS pin of each chip
+//   EncoderLS7366SPI bus;
+//   EncoderLS7366<EncoderLS7366SPI, 3> axes(bus, selects);
+//   axes.begin();
+//   ...
+//   axes.update();              // 1 SPI transaction for all 3 chips
+//   long x = axes.read(0);
+//   long y = axes.read(1);
+//
+// update() first latches every chip's counter into its output register,
+// 1 byte per chip, then reads the latched values.  So all axes are
+// sampled within a few microseconds of each other, and read() returns
+// the same snapshot until the next update().  Call update() once per
+// control loop, from loop() or a timer.
+//
+// The chips count continuously and are never written after begin().
+// write() and readAndReset() only change a software offset, so no count
+// is lost between reading and resetting.  The 32 bit counters wrap the
+// same way Encoder's position does.
+
+// LS7366R instructions: operation in bits 7-6, register in bits 5-3
+#define LS7366_CLR		0x00
+#define LS7366_RD		0x40
+#define LS7366_WR		0x80
+#define LS7366_LOAD		0xC0
+#define LS7366_MDR0		0x08
+#define LS7366_MDR1		0x10
+#define LS7366_DTR		0x18
+#define LS7366_CNTR		0x20
+#define LS7366_OTR		0x28
+#define LS7366_STR		0x30
+
+// MDR0 count modes, for begin()
+#define LS7366_X1		0x01
+#define LS7366_X2		0x02
+#define LS7366_X4		0x03	// every edge, like Encoder
+// MDR1: 4 byte counter, counting enabled, no flags
+#define LS7366_MDR1_4BYTE	0x00
+
+#if !defined(ENCODER_LINUX_GPIO)
+#include <SPI.h>
+
+// The LS7366R works in SPI mode 0.  Its maximum SPI clock depends on
+// the supply voltage, see the datasheet.
+class EncoderLS7366SPI
+{
+public:
+	EncoderLS7366SPI(uint32_t clock = 4000000) : settings(clock, MSBFIRST, SPI_MODE0) { }
+	void begin() { SPI.begin(); }
+	void beginTransaction() { SPI.beginTransaction(settings); }
+	void endTransaction() { SPI.endTransaction(); }
+	void select(uint8_t pin) { digitalWrite(pin, LOW); }
+	void deselect(uint8_t pin) { digitalWrite(pin, HIGH); }
+	// bytes out, replaced by the bytes received
+	void transfer(uint8_t *data, uint8_t bytes) { SPI.transfer(data, bytes); }
+	void setupSelect(uint8_t pin) {
+		pinMode(pin, OUTPUT);
+		digitalWrite(pin, HIGH);
+	}
+private:
+	SPISettings settings;
+};
+#endif
+
+// Bus is EncoderLS7366SPI, or any class with the same 7 functions, like
+// the register level model in extras/linux/ls7366_model.cpp.
+template <class Bus, uint8_t chips>
+class EncoderLS7366
+{
+public:
+	typedef int32_t count_t;
+
+	EncoderLS7366(Bus &b, const uint8_t *selectPins) : transactions(0), bus(b) {
+		for (uint8_t i=0; i < chips; i++) {
+			select[i] = selectPins[i];
+			raw[i] = 0;
+			offset[i] = 0;
+		}
+	}
+	// configure every chip and clear its counter
+	void begin(uint8_t countMode = LS7366_X4) {
+		bus.begin();
+		for (uint8_t i=0; i < chips; i++) bus.setupSelect(select[i]);
+		bus.beginTransaction();
+		for (uint8_t i=0; i < chips; i++) {
+			uint8_t mdr0[2] = {LS7366_WR | LS7366_MDR0, countMode};
+			uint8_t mdr1[2] = {LS7366_WR | LS7366_MDR1, LS7366_MDR1_4BYTE};
+			uint8_t clear[1] = {LS7366_CLR | LS7366_CNTR};
+			command(i, mdr0, 2);
+			command(i, mdr1, 2);
+			command(i, clear, 1);
+			raw[i] = 0;
+			offset[i] = 0;
+		}
+		bus.endTransaction();
+	}
+	// latch and read all the counters, in 1 SPI transaction
+	void update() {
+		uint8_t data[chips][5];
+		bus.beginTransaction();
+		for (uint8_t i=0; i < chips; i++) {
+			uint8_t latch[1] = {LS7366_LOAD | LS7366_OTR};
+			command(i, latch, 1);
+		}
+		for (uint8_t i=0; i < chips; i++) {
+			data[i][0] = LS7366_RD | LS7366_OTR;
+			data[i][1] = data[i][2] = data[i][3] = data[i][4] = 0;
+			command(i, data[i], 5);
+		}
+		bus.endTransaction();
+		noInterrupts();
+		for (uint8_t i=0; i < chips; i++) {
+			raw[i] = ((uint32_t)data[i][1] << 24) | ((uint32_t)data[i][2] << 16)
+				| ((uint32_t)data[i][3] << 8) | data[i][4];
+		}
+		interrupts();
+		transactions++;
+	}
+	// position at the last update()
+	inline count_t read(uint8_t n) {
+		noInterrupts();
+		count_t ret = (count_t)(raw[n] + offset[n]);
+		interrupts();
+		return ret;
+	}
+	inline count_t readAndReset(uint8_t n) {
+		noInterrupts();
+		count_t ret = (count_t)(raw[n] + offset[n]);
+		offset[n] = 0 - raw[n];
+		interrupts();
+		return ret;
+	}
+	inline void write(uint8_t n, count_t p) {
+		noInterrupts();
+		offset[n] = (uint32_t)p - raw[n];
+		interrupts();
+	}
+	// one chip as an object, see utility/encoder_channel.h
+	EncoderChannel<EncoderLS7366> encoder(uint8_t n) {
+		return EncoderChannel<EncoderLS7366>(*this, n);
+	}
+	uint32_t transactions;	// number of update() calls
+private:
+	void command(uint8_t n, uint8_t *data, uint8_t bytes) {
+		bus.select(select[n]);
+		bus.transfer(data, bytes);
+		bus.deselect(select[n]);
+	}
+	Bus &bus;
+	uint8_t select[chips];
+	uint32_t raw[chips];
+	uint32_t offset[chips];
+};
+
+#endif
@@ -0,0 +1,185 @@
+/* Encoder Library - Linux GPIO character device edge events
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderLinuxGpio_h_
+#define EncoderLinuxGpio_h_
+
+#include "Encoder.h"
+
+#ifndef ENCODER_LINUX_GPIO
+#error "EncoderLinuxGpio.h is only for Linux (without an Arduino core)"
+#endif
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+// EncoderGpioEvents runs Encoder on Linux single board computers, using
+// the GPIO character device (/dev/gpiochipN, uAPI v2, kernel 5.10+).
+// The kernel timestamps every edge and queues it, so no edges are lost
+// while the program is busy, as long as the queue does not overflow.
+//
+//   EncoderGpioEvents gpio;
+//   Encoder knob;                       // 2 step setup, see below
+//   const uint8_t lines[] = {17, 27};
+//   gpio.open("/dev/gpiochip0", lines, 2);
+//   knob.begin(17, 27);                 // pins are line offsets
+//   while (1) {
+//     gpio.process();                   // waits for events
+//     printf("%d\n", knob.read());
+//   }
+//
+// Open the lines before begin(), so the encoders start from the real
+// pin levels.  process() may also run in its own thread.  It holds the
+// same lock as noInterrupts(), so read() and write() work like they
+// do with real interrupts.
+//
+// Each read() syscall takes up to ENCODER_LINUX_BATCH events, and they
+// are all handled with the lock taken once, so the cost per edge is a
+// few table lookups plus the normal update().
+//
+// Anything producing struct gpio_v2_line_event works, so begin(fd) with
+// a pipe or file of recorded events is useful for testing.
+
+#ifndef ENCODER_LINUX_BATCH
+#define ENCODER_LINUX_BATCH	64
+#endif
+
+class EncoderGpioEvents
+{
+public:
+	EncoderGpioEvents() : events(0), batches(0), lost(0), fd(-1), fill(0), seq(0) { }
+	~EncoderGpioEvents() { close(); }
+
+	// Request lines as inputs with pullups and both edges, and read
+	// their present levels.  Returns false with errno set on failure.
+	bool open(const char *chip, const uint8_t *lines, uint8_t count,
+	  uint64_t flags = GPIO_V2_LINE_FLAG_BIAS_PULL_UP) {
+		if (count == 0 || count > GPIO_V2_LINES_MAX) {
+			errno = EINVAL;
+			return false;
+		}
+		int chipfd = ::open(chip, O_RDONLY | O_CLOEXEC);
+		if (chipfd < 0) return false;
+		struct gpio_v2_line_request req;
+		memset(&req, 0, sizeof(req));
+		for (uint8_t i=0; i < count; i++) req.offsets[i] = lines[i];
+		strncpy(req.consumer, "Encoder", sizeof(req.consumer) - 1);
+		req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING
+			| GPIO_V2_LINE_FLAG_EDGE_FALLING | flags;
+		req.num_lines = count;
+		req.event_buffer_size = 16 * ENCODER_LINUX_BATCH;
+		int r = ioctl(chipfd, GPIO_V2_GET_LINE_IOCTL, &req);
+		::close(chipfd);
+		if (r < 0) return false;
+		struct gpio_v2_line_values values;
+		values.mask = (count < 64) ? ((uint64_t)1 << count) - 1 : ~(uint64_t)0;
+		values.bits = 0;
+		if (ioctl(req.fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+			int e = errno;
+			::close(req.fd);
+			errno = e;
+			return false;
+		}
+		for (uint8_t i=0; i < count; i++) {
+			setLevel(lines[i], (values.bits >> i) & 1);
+		}
+		begin(req.fd);
+		return true;
+	}
+	// use an already open source of events, which this object then owns
+	void begin(int eventfd) {
+		close();
+		fd = eventfd;
+		fill = 0;
+	}
+	// set a line's level, before begin() of encoders using it
+	void setLevel(uint8_t line, uint8_t level) {
+		encoder_linux_levels()[line] = level ? 1 : 0;
+	}
+	void close() {
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+	}
+	int handle() const { return fd; }
+
+	// Wait up to timeout milliseconds (-1 forever) for events.
+	bool wait(int timeout) {
+		struct pollfd p;
+		p.fd = fd;
+		p.events = POLLIN;
+		p.revents = 0;
+		return ::poll(&p, 1, timeout) > 0;
+	}
+	// One read() of up to ENCODER_LINUX_BATCH events, which blocks
+	// unless the descriptor is non-blocking.  Returns the number of
+	// events handled, 0 at end of file, or -1 with errno set.
+	int process() {
+		uint8_t *bytes = (uint8_t *)buffer;
+		// a pipe may split an event between reads, so keep reading
+		// until at least 1 is complete, and save any extra part for
+		// next time
+		do {
+			ssize_t n = ::read(fd, bytes + fill, sizeof(buffer) - fill);
+			if (n <= 0) return (int)n;
+			fill += n;
+		} while (fill < sizeof(struct gpio_v2_line_event));
+		size_t count = fill / sizeof(struct gpio_v2_line_event);
+		encoder_linux_isr_t *vectors = encoder_linux_vectors();
+		volatile uint8_t *levels = encoder_linux_levels();
+		noInterrupts();
+		for (size_t i=0; i < count; i++) {
+			uint32_t line = buffer[i].offset;
+			if (buffer[i].seqno != seq + 1 && seq != 0) lost += buffer[i].seqno - seq - 1;
+			seq = buffer[i].seqno;
+			if (line >= ENCODER_LINUX_LINES) continue;
+			levels[line] = (buffer[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE) ? 1 : 0;
+			if (vectors[line]) {
+				encoder_linux_event_ns() = buffer[i].timestamp_ns;
+				(*vectors[line])(line);
+			}
+		}
+		encoder_linux_event_ns() = 0;
+		interrupts();
+		size_t used = count * sizeof(struct gpio_v2_line_event);
+		fill -= used;
+		if (fill) memmove(bytes, bytes + used, fill);
+		events += count;
+		batches++;
+		return (int)count;
+	}
+	uint32_t events;	// edges handled
+	uint32_t batches;	// read() calls which returned data
+	uint32_t lost;		// gaps in the kernel's sequence numbers
+private:
+	int fd;
+	size_t fill;
+	uint32_t seq;
+	struct gpio_v2_line_event buffer[ENCODER_LINUX_BATCH];
+};
+
+#endif
@@ -0,0 +1,145 @@
+/* Encoder Library - stall, reversal and overspeed detection
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderMonitor_h_
+#define EncoderMonitor_h_
+
+#include "Encoder.h"
+
+// EncoderMonitor watches the edge timing Encoder records when
+// ENCODER_TRACK_MOTION is defined, or BasicEncoderMonitor for any
+// BasicEncoder with track_motion in its traits.  The interrupt routine
+// stores the micros() time of each count, the time since the previous
+// count and the direction.  From that, these conditions are O(1) to test:
+//
+//   stalled()    no count for longer than the stall timeout
+//   overspeed()  counts arriving closer together than the limit
+//   reversed()   direction changed since the last call to reversed()
+//
+// For callbacks, call check() from a timer interrupt (IntervalTimer on
+// Teensy, or any periodic timer) running at least as often as the stall
+// timeout.  Then detection happens within timeout + timer period, no
+// matter how slowly loop() runs.  check() may also simply be called
+// from loop(), if loop() is known to be fast enough.
+//
+// Callbacks run in whatever context calls check().  When that is a
+// timer interrupt, keep them short.  check() reads the motion with
+// Encoder::readMotion(), which never turns interrupts back on inside
+// an interrupt.
+//
+// Reversals are counted in 16 bits, so reversed() and check() miss them
+// only if exactly a multiple of 65536 happen between 2 calls.  Every
+// reversal takes at least one count, so calling at least every 65535
+// counts is always enough.
+
+template <class EncoderType>
+class BasicEncoderMonitor
+{
+	static_assert(EncoderType::traits_type::track_motion,
+		"EncoderMonitor needs #define ENCODER_TRACK_MOTION before #include <Encoder.h>");
+public:
+	BasicEncoderMonitor(EncoderType &enc) : encoder(enc) {
+		stall_timeout = 100000;
+		overspeed_interval = 0;
+		stall_function = 0;
+		reverse_function = 0;
+		overspeed_function = 0;
+		Encoder_motion_t m = encoder.readMotion();
+		check_edge = m.last_edge;
+		check_reversals = m.reversals;
+		query_reversals = m.reversals;
+		is_stalled = false;
+		is_overspeed = false;
+	}
+	// no count for this many microseconds is a stall
+	void setStallTimeout(uint32_t microseconds) { stall_timeout = microseconds; }
+	// counts less than this many microseconds apart are overspeed,
+	// 0 disables overspeed detection
+	void setOverspeedInterval(uint32_t microseconds) { overspeed_interval = microseconds; }
+	void onStall(void (*function)(void)) { stall_function = function; }
+	void onReverse(void (*function)(void)) { reverse_function = function; }
+	void onOverspeed(void (*function)(void)) { overspeed_function = function; }
+
+	bool stalled() {
+		Encoder_motion_t m = encoder.readMotion();
+		if (is_stalled && m.last_edge == check_edge) return true;
+		return (uint32_t)micros() - m.last_edge >= stall_timeout;
+	}
+	bool overspeed() {
+		Encoder_motion_t m = encoder.readMotion();
+		return is_overspeed_now(m, micros());
+	}
+	bool reversed() {
+		uint16_t r = encoder.readMotion().reversals;
+		bool ret = (r != query_reversals);
+		query_reversals = r;
+		return ret;
+	}
+	int8_t direction() { return encoder.readMotion().direction; }
+
+	// Test all conditions and call the callbacks for any which have
+	// started since the previous check().  Stall and overspeed are only
+	// reported once, until motion resumes or the speed drops again.
+	void check() {
+		Encoder_motion_t m = encoder.readMotion();
+		uint32_t now = micros();
+		if (m.last_edge != check_edge) {
+			check_edge = m.last_edge;
+			is_stalled = false;
+		} else if (!is_stalled && now - m.last_edge >= stall_timeout) {
+			// latched, so micros() rolling over can not hide a stall
+			is_stalled = true;
+			if (stall_function) (*stall_function)();
+		}
+		if (m.reversals != check_reversals) {
+			check_reversals = m.reversals;
+			if (reverse_function) (*reverse_function)();
+		}
+		bool over = is_overspeed_now(m, now);
+		if (over && !is_overspeed) {
+			if (overspeed_function) (*overspeed_function)();
+		}
+		is_overspeed = over;
+	}
+private:
+	bool is_overspeed_now(const Encoder_motion_t &m, uint32_t now) {
+		// the interval is only meaningful while counts are still arriving
+		return overspeed_interval > 0 && m.interval < overspeed_interval
+			&& now - m.last_edge < overspeed_interval;
+	}
+	EncoderType &encoder;
+	uint32_t stall_timeout;
+	uint32_t overspeed_interval;
+	void (*stall_function)(void);
+	void (*reverse_function)(void);
+	void (*overspeed_function)(void);
+	uint32_t check_edge;
+	uint16_t check_reversals;
+	uint16_t query_reversals;
+	volatile bool is_stalled;
+	bool is_overspeed;
+};
+
+typedef BasicEncoderMonitor<Encoder> EncoderMonitor;
+
+#endif
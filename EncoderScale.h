@@ -0,0 +1,156 @@
+/* Encoder Library - fixed point unit conversion
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderScale_h_
+#define EncoderScale_h_
+
+#include "Encoder.h"
+
+// EncoderScale converts counts to engineering units (um, degrees, mm/s)
+// as integers, without float math or a divide.  The ratio of units per
+// count is a compile time fraction, with optional fraction bits for
+// fixed point results:
+//
+//   EncoderRatio<5, 2>              2.5 um per count, result in um
+//   EncoderRatio<360, 4096, 16>     degrees as Q16.16, 65536 = 1 degree
+//   EncoderRatio<254, 1000, 8>      0.254 mm per count, 1/256 mm units
+//
+// The compiler reduces the fraction and splits it into a whole part and
+// a remainder, then turns remainder / divisor into a 32 bit multiplier,
+// so each conversion is 1 multiply for the whole part and one 32x32 to
+// 64 bit multiply with a shift for the rest.  On AVR that is far fewer
+// cycles than float, and on 32 bit ARM just a few instructions.
+//
+// The result is exactly floor(counts * ratio), the same as a divide
+// with rational arithmetic, for all counts within +/- exact_limit,
+// which depends on the ratio and is often the whole 32 bit range.
+// Beyond it, the result may be 1 unit high.
+// The result must fit in 32 bits.
+//
+// readVelocity() is in units per second.  Call sample() every period
+// microseconds (the 3rd template parameter) from a timer, or a loop
+// with exact timing, and the change in position is scaled the same way,
+// with 1000000 / period folded into the ratio.  Velocity from the time
+// between counts (Traits::track_motion) would need a divide by that
+// time on every read, so it is not used here.
+//
+//   Encoder myEnc(2, 3);
+//   BasicEncoderScale<Encoder, EncoderRatio<5, 2>, 1000> axis(myEnc);
+//   int32_t um = axis.read();
+//   axis.sample();                    // every 1000 us
+//   int32_t um_per_sec = axis.readVelocity();
+
+template <uint64_t a, uint64_t b>
+struct Encoder_gcd {
+	static const uint64_t value = Encoder_gcd<b, a % b>::value;
+};
+
+template <uint64_t a>
+struct Encoder_gcd<a, 0> {
+	static const uint64_t value = a;
+};
+
+// Multiply-shift constants for floor(counts * p / q), reduced first.
+// Positive counts use the multiplier rounded up, negative ones rounded
+// down, so either way the error pushes the result toward the next
+// integer, which it does not reach while |counts| * error < 2^32.
+template <uint64_t p_in, uint64_t q_in>
+struct Encoder_scale_constants {
+	static const uint64_t numerator = p_in / Encoder_gcd<p_in, q_in>::value;
+	static const uint64_t denominator = q_in / Encoder_gcd<p_in, q_in>::value;
+	static const uint64_t q = denominator;
+	static_assert(q > 0 && q <= 0xFFFFFFFF, "EncoderRatio divisor must fit in 32 bits");
+	static_assert(numerator / q <= 0x7FFFFFFF, "EncoderRatio above 2^31 units per count");
+	static const int32_t whole = (int32_t)(numerator / q);
+	static const uint64_t shifted = (numerator % q) << 32;
+	static const uint32_t m_down = (uint32_t)(shifted / q);
+	static const uint32_t m_up = (uint32_t)(m_down + (shifted % q ? 1 : 0));
+	static const uint64_t e_down = shifted - (uint64_t)m_down * q;
+	static const uint64_t e_up = (uint64_t)m_up * q - shifted;
+	static const uint64_t e_max = (e_up > e_down) ? e_up : e_down;
+	static const uint64_t limit = e_max ? 0xFFFFFFFFull / e_max : 0x7FFFFFFF;
+	static const int32_t exact_limit = (int32_t)((limit < 0x7FFFFFFF) ? limit : 0x7FFFFFFF);
+
+	static inline int32_t convert(int32_t counts) {
+		int32_t n = (int32_t)((uint32_t)counts * (uint32_t)whole);
+		if (shifted == 0) return n;
+		// >> of a negative number is an arithmetic shift (floor) in gcc
+		int64_t f = (int64_t)counts * (counts >= 0 ? m_up : m_down);
+		return n + (int32_t)(f >> 32);
+	}
+};
+
+// units per count = num / den, times 2^fraction_bits
+template <uint32_t num, uint32_t den, uint8_t fraction_bits = 0>
+struct EncoderRatio : Encoder_scale_constants<(uint64_t)num << fraction_bits, den> {
+	static_assert(num > 0 && den > 0, "EncoderRatio needs a nonzero fraction");
+	static_assert(fraction_bits < 32, "EncoderRatio has at most 31 fraction bits");
+};
+
+// The same ratio per second, for a change in counts over period us.
+// Common factors are removed before multiplying, to keep both parts
+// within 64 bits.
+template <class Ratio, uint32_t period>
+struct Encoder_rate_constants {
+	static const uint64_t p = Ratio::numerator;
+	static const uint64_t q = Ratio::denominator;
+	static const uint64_t g1 = Encoder_gcd<1000000, q>::value;
+	static const uint64_t g2 = Encoder_gcd<p, period>::value;
+	static const uint64_t scale = 1000000 / g1;
+	static_assert(p / g2 <= 0xFFFFFFFFFFFFFFFFull / scale, "EncoderScale velocity ratio too large");
+	typedef Encoder_scale_constants<p / g2 * scale, q / g1 * (period / g2)> type;
+};
+
+template <class EncoderType, class Ratio, uint32_t period = 1000>
+class BasicEncoderScale
+{
+	static_assert(period > 0, "EncoderScale period must be nonzero");
+	typedef typename Encoder_rate_constants<Ratio, period>::type Rate;
+public:
+	BasicEncoderScale(EncoderType &enc) : encoder(enc), last(0), velocity(0), sampled(false) { }
+	// position in units
+	inline int32_t read() { return Ratio::convert(encoder.read()); }
+	// any count, such as a target from a compare callback
+	static inline int32_t toUnits(int32_t counts) { return Ratio::convert(counts); }
+	// velocity in units per second, from counts in 1 period
+	static inline int32_t toUnitsPerSecond(int32_t counts) { return Rate::convert(counts); }
+	// call every period microseconds, the first call only starts
+	void sample() {
+		int32_t position = encoder.read();
+		if (sampled) {
+			velocity = Rate::convert((int32_t)((uint32_t)position - (uint32_t)last));
+		}
+		last = position;
+		sampled = true;
+	}
+	// units per second, as of the last sample()
+	int32_t readVelocity() const { return velocity; }
+	static const int32_t exact_limit = Ratio::exact_limit;
+private:
+	EncoderType &encoder;
+	int32_t last;
+	int32_t velocity;
+	bool sampled;
+};
+
+#endif
@@ -0,0 +1,224 @@
+/* Encoder Library - many encoders through 74HC165 shift registers
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderShift_h_
+#define EncoderShift_h_
+
+#include "Encoder.h"
+#include "utility/encoder_channel.h"
+
+// EncoderShift reads any number of encoders through a chain of 74HC165
+// parallel-in / serial-out shift registers, using only 3 pins (or SPI
+// plus 1).  Each chip holds 4 encoders.  Nothing interrupts on edges,
+// instead scan() must be called often enough to see every state, from
+// loop() or better from a timer interrupt.
+//
+//   EncoderShiftSPI bus(10);                        // load (SH/LD) pin
+//   EncoderShift<EncoderShiftSPI, 48> knobs(bus);   // 12 chips
+//   ...
+//   knobs.scan();                                   // from a timer
+//   long level = knobs.read(7);
+//   EncoderChannel<EncoderShift<EncoderShiftSPI, 48> > fader = knobs.encoder(7);
+//
+// Wiring: the first encoder connects to inputs H (pin 1) and G (pin 2)
+// of the chip whose QH output goes to the board, the next to F and E,
+// and so on, then the next chip down the chain.  Each chip's SER input
+// connects to the QH of the next chip.
+//
+// Decoding is bit-parallel.  The chain is handled as 32 bit words of 16
+// encoders, and a few logic operations on the old and new words find
+// which encoders moved and in which direction, all 16 at once.  Only
+// encoders which moved cost anything more, so a scan of 48 idle knobs
+// is mostly the time to shift in 6 bytes.
+
+// On Linux there are no output pins, so give EncoderShift your own Bus
+// class, for example using spidev.
+#if !defined(ENCODER_LINUX_GPIO)
+#include <SPI.h>
+
+// Load the chain with a pulse on SH/LD, then read it with SPI, mode 0.
+// Connect SCK to CLK, MISO to QH, and CLK INH to ground.
+
+class EncoderShiftSPI
+{
+public:
+	EncoderShiftSPI(uint8_t loadPin, uint32_t clock = 8000000)
+	  : load(loadPin), settings(clock, MSBFIRST, SPI_MODE0) { }
+	void begin() {
+		pinMode(load, OUTPUT);
+		digitalWrite(load, HIGH);
+		SPI.begin();
+	}
+	void read(uint8_t *data, uint8_t bytes) {
+		digitalWrite(load, LOW);
+		digitalWrite(load, HIGH);
+		SPI.beginTransaction(settings);
+		for (uint8_t i=0; i < bytes; i++) data[i] = SPI.transfer(0);
+		SPI.endTransaction();
+	}
+private:
+	uint8_t load;
+	SPISettings settings;
+};
+
+// Load the chain and shift it in with any 3 pins.
+class EncoderShiftPins
+{
+public:
+	EncoderShiftPins(uint8_t loadPin, uint8_t clockPin, uint8_t dataPin)
+	  : load(loadPin), clock(clockPin), data_pin(dataPin) { }
+	void begin() {
+		pinMode(load, OUTPUT);
+		pinMode(clock, OUTPUT);
+		digitalWrite(load, HIGH);
+		digitalWrite(clock, LOW);
+		pinMode(data_pin, INPUT);
+		data_register = PIN_TO_BASEREG(data_pin);
+		data_bitmask = PIN_TO_BITMASK(data_pin);
+	}
+	void read(uint8_t *data, uint8_t bytes) {
+		digitalWrite(load, LOW);
+		digitalWrite(load, HIGH);
+		for (uint8_t i=0; i < bytes; i++) {
+			uint8_t b = 0;
+			for (uint8_t bit=0; bit < 8; bit++) {
+				b = (b << 1) | DIRECT_PIN_READ(data_register, data_bitmask);
+				digitalWrite(clock, HIGH);
+				digitalWrite(clock, LOW);
+			}
+			data[i] = b;
+		}
+	}
+private:
+	uint8_t load, clock, data_pin;
+	volatile IO_REG_TYPE * data_register;
+	IO_REG_TYPE data_bitmask;
+};
+#endif
+
+// Bus is EncoderShiftSPI, EncoderShiftPins, or any class with
+// begin() and read(data, bytes).  Traits::count_t and Traits::filter
+// work like they do for Encoder.
+template <class Bus, uint8_t encoders, class Traits = EncoderDefaultTraits>
+class EncoderShift
+{
+public:
+	typedef typename Traits::count_t count_t;
+	static const uint8_t bytes = (encoders + 3) / 4;
+	static const uint8_t words = (encoders + 15) / 16;
+
+	EncoderShift(Bus &b) : scans(0), bus(b), started(false) {
+		for (uint8_t i=0; i < encoders; i++) position[i] = 0;
+	}
+	// start the bus and read the initial state
+	void begin() {
+		bus.begin();
+		started = false;
+		scan();
+	}
+	// Read the chain and count every encoder which moved.  Call this
+	// from a timer interrupt, or from loop(), but only one of them:
+	// scan() must not interrupt itself.  read() and write() work from
+	// anywhere.
+	void scan() {
+		uint8_t data[words * 4];
+		for (uint8_t i=bytes; i < words * 4; i++) data[i] = 0;
+		bus.read(data, bytes);
+		for (uint8_t w=0; w < words; w++) {
+			const uint8_t *p = data + w * 4;
+			uint32_t now = p[0] | ((uint32_t)p[1] << 8)
+				| ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+			if (started) decode(w, state[w], now);
+			state[w] = now;
+		}
+		started = true;
+		scans++;
+	}
+	inline count_t read(uint8_t n) {
+		noInterrupts();
+		count_t ret = position[n];
+		interrupts();
+		return ret;
+	}
+	inline count_t readAndReset(uint8_t n) {
+		noInterrupts();
+		count_t ret = position[n];
+		position[n] = 0;
+		interrupts();
+		return ret;
+	}
+	inline void write(uint8_t n, count_t p) {
+		noInterrupts();
+		position[n] = p;
+		interrupts();
+	}
+	// one encoder as an object, see utility/encoder_channel.h
+	EncoderChannel<EncoderShift> encoder(uint8_t n) {
+		return EncoderChannel<EncoderShift>(*this, n);
+	}
+	uint32_t scans;		// number of scan() calls
+private:
+	// Each encoder is a 2 bit lane: pin1 (A) in the odd bit, pin2 (B)
+	// in the even bit.  For 1 step, the direction is old A xor new B,
+	// which matches Encoder's table, including its guess for 2 steps.
+	void decode(uint8_t w, uint32_t old, uint32_t now) {
+		const uint32_t lanes = 0x55555555;
+		uint32_t changed = old ^ now;
+		if (!changed) return;
+		uint32_t moved = (changed | (changed >> 1)) & lanes;
+		uint32_t both = changed & (changed >> 1) & lanes;
+		uint32_t up = ((old >> 1) ^ now) & moved;
+		if (Traits::filter == ENCODER_FILTER_REJECT) moved &= ~both;
+		while (moved) {
+			uint8_t lane = first_bit(moved);
+			moved &= moved - 1;
+			// bits 7,6 of a byte are the first of its 4 encoders
+			uint8_t n = w * 16 + (lane >> 3) * 4 + 3 - ((lane & 7) >> 1);
+			if (n >= encoders) continue;
+			int8_t d = (both >> lane & 1) ? 2 : 1;
+			if (up >> lane & 1) {
+				position[n] += d;
+			} else {
+				position[n] -= d;
+			}
+		}
+	}
+	static inline uint8_t first_bit(uint32_t x) {
+#if defined(__GNUC__)
+		return __builtin_ctzl(x);
+#else
+		uint8_t n = 0;
+		while (!(x & 1)) {
+			x >>= 1;
+			n++;
+		}
+		return n;
+#endif
+	}
+	Bus &bus;
+	bool started;
+	uint32_t state[words];
+	count_t position[encoders];
+};
+
+#endif
@@ -0,0 +1,135 @@
+/* Encoder Library - compact binary streaming of encoder positions
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderTelemetry_h_
+#define EncoderTelemetry_h_
+
+#include "Encoder.h"
+#include "EncoderTelemetryDecoder.h"
+
+// EncoderTelemetry sends the positions of several encoders as small
+// binary frames, at a fixed rate.  Each value is the change since the
+// previous frame, as a zigzag varint, so slowly moving axes need only
+// 1 byte.  Every keyInterval frames, a key frame carries the absolute
+// positions, so a receiver can start or recover at any time.  See
+// EncoderTelemetryDecoder.h for the format and the matching decoder,
+// which also compiles on a PC.
+//
+// Frame size is 6 bytes overhead plus about 1 byte per axis, compared to
+// 5 to 12 bytes per axis for Serial.println(position).  4 slowly moving
+// axes at 115200 baud fit about 1100 frames/sec, instead of a few hundred.
+//
+// Call update() often from loop().  It reads the encoders and sends a
+// frame only when one is due.  Serial.write() waits if the transmit
+// buffer is full, so choose a rate the baud rate can carry (the
+// TelemetryRate example measures the rate each baud rate carries).
+
+#ifndef ENCODER_TELEMETRY_AXES
+#define ENCODER_TELEMETRY_AXES 8
+#endif
+static_assert(ENCODER_TELEMETRY_AXES > 0 && ENCODER_TELEMETRY_AXES <= ENCODER_TELEMETRY_MAX_AXES,
+	"ENCODER_TELEMETRY_AXES must be 1 to ENCODER_TELEMETRY_MAX_AXES, which the decoder can receive");
+
+template <class EncoderType>
+class BasicEncoderTelemetry
+{
+public:
+	BasicEncoderTelemetry(Print &output) : out(output) {
+		num_axes = 0;
+		seq = 0;
+		frames_until_key = 0;
+		keyInterval = 32;
+		setRate(100);
+	}
+	// add an encoder, returns false if ENCODER_TELEMETRY_AXES are in use
+	bool add(EncoderType &enc) {
+		if (num_axes >= ENCODER_TELEMETRY_AXES) return false;
+		encoders[num_axes++] = &enc;
+		frames_until_key = 0;
+		return true;
+	}
+	void setRate(uint32_t framesPerSecond) {
+		interval = framesPerSecond ? 1000000 / framesPerSecond : 0;
+		last_time = micros();
+	}
+	// a key frame is sent every keyInterval frames
+	void setKeyInterval(uint8_t frames) { keyInterval = frames ? frames : 1; }
+	// send a frame if one is due, returns true if it did
+	bool update() {
+		uint32_t now = micros();
+		if (now - last_time < interval) return false;
+		last_time += interval;
+		// after a long stall, don't try to catch up with a burst
+		if (now - last_time >= interval) last_time = now;
+		send();
+		return true;
+	}
+	// send a frame now, returning the number of bytes written
+	uint8_t send() {
+		int32_t pos[ENCODER_TELEMETRY_AXES];
+		for (uint8_t i=0; i < num_axes; i++) {
+			pos[i] = encoders[i]->read();
+		}
+		return send(pos, num_axes);
+	}
+	// send any positions, not necessarily from encoders.  Returns 0 and
+	// sends nothing if count is more than ENCODER_TELEMETRY_AXES.
+	uint8_t send(const int32_t *pos, uint8_t count) {
+		if (count > ENCODER_TELEMETRY_AXES) return 0;
+		uint8_t buf[ENCODER_TELEMETRY_AXES * 5 + 6];
+		bool key = (frames_until_key == 0);
+		frames_until_key = key ? keyInterval - 1 : frames_until_key - 1;
+		uint8_t len = 2;
+		buf[len++] = count | (key ? ENCODER_TELEMETRY_KEY : 0);
+		buf[len++] = seq++;
+		for (uint8_t i=0; i < count; i++) {
+			int32_t v = key ? pos[i] : (int32_t)((uint32_t)pos[i] - (uint32_t)prev[i]);
+			len += encoder_telemetry_varint(buf + len, encoder_telemetry_zigzag(v));
+			prev[i] = pos[i];
+		}
+		buf[0] = ENCODER_TELEMETRY_SYNC;
+		buf[1] = len - 2;
+		uint16_t crc = 0xFFFF;
+		for (uint8_t i=1; i < len; i++) {
+			crc = encoder_telemetry_crc(crc, buf[i]);
+		}
+		buf[len++] = crc;
+		buf[len++] = crc >> 8;
+		out.write(buf, len);
+		return len;
+	}
+private:
+	Print &out;
+	EncoderType *encoders[ENCODER_TELEMETRY_AXES];
+	int32_t prev[ENCODER_TELEMETRY_AXES];
+	uint32_t interval;
+	uint32_t last_time;
+	uint8_t num_axes;
+	uint8_t seq;
+	uint8_t keyInterval;
+	uint8_t frames_until_key;
+};
+
+typedef BasicEncoderTelemetry<Encoder> EncoderTelemetry;
+
+#endif
@@ -0,0 +1,204 @@
+/* Encoder Library - telemetry stream format and decoder
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ * Copyright (c) 2011,2013 PJRC.COM, LLC - Paul Stoffregen <paul@pjrc.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef EncoderTelemetryDecoder_h_
+#define EncoderTelemetryDecoder_h_
+
+// This file has no Arduino dependencies, so the same code decodes the
+// stream on a PC, Raspberry Pi, or another board.
+#include <stdint.h>
+
+// Frame format, sent by EncoderTelemetry:
+//
+//   0xA5        sync
+//   length      number of bytes from flags to the last value
+//   flags       bit 7: key frame, bits 0-6: number of axes
+//   sequence    increments by 1 every frame
+//   values      one zigzag varint per axis, absolute position in key
+//               frames, change since the previous frame otherwise
+//   crc         CRC-16/CCITT of length through values, low byte first
+//
+// A varint holds 7 bits per byte, low bits first, with bit 7 set on all
+// but the last byte.  Zigzag maps 0, -1, 1, -2, 2 ... to 0, 1, 2, 3, 4 ...
+// so small changes in either direction take 1 byte.  An axis moving
+// less than 64 counts per frame costs just 1 byte.
+//
+// After lost or corrupted data, the decoder looks for the next 0xA5 with
+// a good CRC, then waits for a key frame before reporting positions.
+
+#define ENCODER_TELEMETRY_SYNC		0xA5
+#define ENCODER_TELEMETRY_KEY		0x80
+#define ENCODER_TELEMETRY_MAX_AXES	16
+// flags + sequence + 5 byte varint per axis
+#define ENCODER_TELEMETRY_MAX_PAYLOAD	(2 + 5 * ENCODER_TELEMETRY_MAX_AXES)
+
+static inline uint16_t encoder_telemetry_crc(uint16_t crc, uint8_t data)
+{
+	crc ^= (uint16_t)data << 8;
+	for (uint8_t i=0; i < 8; i++) {
+		crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+	}
+	return crc;
+}
+
+static inline uint32_t encoder_telemetry_zigzag(int32_t n)
+{
+	return ((uint32_t)n << 1) ^ (uint32_t)(n >> 31);
+}
+
+static inline int32_t encoder_telemetry_unzigzag(uint32_t n)
+{
+	return (int32_t)(n >> 1) ^ -(int32_t)(n & 1);
+}
+
+// store a varint, returning the number of bytes used (1 to 5)
+static inline uint8_t encoder_telemetry_varint(uint8_t *buf, uint32_t n)
+{
+	uint8_t len = 0;
+	while (n >= 0x80) {
+		buf[len++] = (n & 0x7F) | 0x80;
+		n >>= 7;
+	}
+	buf[len++] = n;
+	return len;
+}
+
+class EncoderTelemetryDecoder
+{
+public:
+	EncoderTelemetryDecoder() {
+		reset();
+		frames = 0;
+		crcErrors = 0;
+		lostFrames = 0;
+	}
+	// forget everything, wait for sync and a key frame
+	void reset() {
+		len = 0;
+		seq = 0;
+		synced = false;
+		valid = false;
+		num_axes = 0;
+	}
+	// Give the decoder one received byte.  Returns true when a frame
+	// completes and the positions are valid.
+	bool decode(uint8_t b) {
+		if (len == 0 && b != ENCODER_TELEMETRY_SYNC) return false;
+		buf[len++] = b;
+		bool ready = false;
+		while (len >= 2) {
+			uint8_t payload = buf[1];
+			if (payload < 2 || payload > ENCODER_TELEMETRY_MAX_PAYLOAD) {
+				crcErrors++;
+				discard(1);
+				continue;
+			}
+			uint8_t size = payload + 4;
+			if (len < size) break;
+			if (check()) {
+				ready = valid;
+				discard(size);
+			} else {
+				// maybe a false sync, retry from the next 0xA5
+				crcErrors++;
+				discard(1);
+			}
+		}
+		return ready;
+	}
+	// feed a whole buffer, returning how many complete frames it held
+	int decode(const uint8_t *data, int count) {
+		int n = 0;
+		for (int i=0; i < count; i++) {
+			if (decode(data[i])) n++;
+		}
+		return n;
+	}
+	uint8_t axes() const { return num_axes; }
+	int32_t position(uint8_t axis) const { return pos[axis]; }
+	uint8_t sequence() const { return seq; }
+	uint32_t frames;	// good frames
+	uint32_t crcErrors;	// frames rejected by CRC or bad length
+	uint32_t lostFrames;	// gaps in the sequence numbers, up to 255 each
+private:
+	bool check() {
+		uint8_t payload = buf[1];
+		uint16_t crc = 0xFFFF;
+		for (uint8_t i=1; i < payload + 2; i++) {
+			crc = encoder_telemetry_crc(crc, buf[i]);
+		}
+		if ((buf[payload + 2] | (buf[payload + 3] << 8)) != crc) return false;
+		uint8_t flags = buf[2];
+		uint8_t n = flags & 0x7F;
+		if (n > ENCODER_TELEMETRY_MAX_AXES) return false;
+		int32_t value[ENCODER_TELEMETRY_MAX_AXES];
+		uint8_t i = 4, axis = 0;
+		while (axis < n) {
+			uint32_t v = 0;
+			uint8_t shift = 0;
+			do {
+				if (i >= payload + 2 || shift > 28) return false;
+				v |= (uint32_t)(buf[i] & 0x7F) << shift;
+				shift += 7;
+			} while (buf[i++] & 0x80);
+			value[axis++] = encoder_telemetry_unzigzag(v);
+		}
+		if (i != payload + 2) return false;
+		frames++;
+		uint8_t s = buf[3];
+		if (synced && s != (uint8_t)(seq + 1)) {
+			lostFrames += (uint8_t)(s - seq - 1);
+			valid = false;		// deltas are useless until a key frame
+		}
+		seq = s;
+		synced = true;
+		if (flags & ENCODER_TELEMETRY_KEY) {
+			for (axis=0; axis < n; axis++) pos[axis] = value[axis];
+			num_axes = n;
+			valid = true;
+		} else if (valid && n == num_axes) {
+			for (axis=0; axis < n; axis++) {
+				pos[axis] = (int32_t)((uint32_t)pos[axis] + (uint32_t)value[axis]);
+			}
+		} else {
+			valid = false;
+		}
+		return true;
+	}
+	// remove n bytes, then anything up to the next sync byte
+	void discard(uint8_t n) {
+		while (n < len && buf[n] != ENCODER_TELEMETRY_SYNC) n++;
+		uint8_t i = 0;
+		while (n < len) buf[i++] = buf[n++];
+		len = i;
+	}
+	uint8_t buf[ENCODER_TELEMETRY_MAX_PAYLOAD + 4];
+	uint8_t len;
+	uint8_t seq;
+	uint8_t num_axes;
+	bool synced;		// seq is from a good frame
+	bool valid;
+	int32_t pos[ENCODER_TELEMETRY_MAX_AXES];
+};
+
+#endif
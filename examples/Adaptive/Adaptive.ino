@@ -0,0 +1,58 @@
+/* Encoder Library - Adaptive Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// EncoderAdaptive counts with interrupts at normal speed, and switches
+// to polling from a timer when the encoder turns so fast that the
+// interrupts would use more CPU time than the polling.
+
+#include <Encoder.h>
+#include <EncoderAdaptive.h>
+
+// Change these pin numbers to the pins connected to your encoder.
+// Both pins should have interrupt capability.
+Encoder myEnc(5, 6);
+//   avoid using pins with LEDs attached
+
+const uint32_t tickRate = 20000;	// timer polls per second
+EncoderAdaptive adaptive(myEnc, 5, 6, tickRate);
+
+#if defined(TEENSYDUINO)
+IntervalTimer timer;
+#endif
+
+void tick() {
+  adaptive.tick();
+}
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Encoder Adaptive Test:");
+  // polling above 12000 counts/sec, interrupts again below 8000
+  adaptive.setThresholds(12000, 8000);
+#if defined(TEENSYDUINO)
+  timer.begin(tick, 1000000 / tickRate);
+#endif
+}
+
+unsigned long lastTick = 0, lastPrint = 0;
+
+void loop() {
+#if !defined(TEENSYDUINO)
+  // without a timer library, tick from loop(), which must not be busy
+  while (micros() - lastTick >= 1000000 / tickRate) {
+    lastTick += 1000000 / tickRate;
+    tick();
+  }
+#endif
+  adaptive.update();    // switches mode when tick() asks for it
+  if (millis() - lastPrint >= 500) {
+    lastPrint = millis();
+    Serial.print(myEnc.read());
+    Serial.print(adaptive.polling() ? "  polling, " : "  interrupts, ");
+    Serial.print(adaptive.rate());
+    Serial.println(" counts/sec");
+  }
+}
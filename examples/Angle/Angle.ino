@@ -0,0 +1,37 @@
+/* Encoder Library - Angle Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+#include <Encoder.h>
+#include <EncoderAngle.h>
+
+// Change these two numbers to the pins connected to your encoder.
+//   Best Performance: both pins have interrupt capability
+//   Good Performance: only the first pin has interrupt capability
+//   Low Performance:  neither pin has interrupt capability
+Encoder myEnc(5, 6);
+//   avoid using pins with LEDs attached
+
+// A 100 line (400 count) optical encoder on a rotary axis.
+EncoderAngle myAxis(myEnc, 400);
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Encoder Angle Test:");
+}
+
+long oldAngle = -999;
+
+void loop() {
+  int32_t turns;
+  int32_t angle = myAxis.readAngle(turns);
+  if (angle != oldAngle) {
+    oldAngle = angle;
+    Serial.print("Angle = ");
+    Serial.print(angle);
+    Serial.print(", Turns = ");
+    Serial.println(turns);
+  }
+}
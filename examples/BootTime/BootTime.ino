@@ -0,0 +1,59 @@
+/* Encoder Library - BootTime - startup time of many encoders
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Every Encoder waits ENCODER_SETTLE_MICROSECONDS (default 2000) after
+// turning on the pullup resistors, so a passive R-C filter can charge
+// before the initial state is read.  With 24 encoders begin() spends
+// 48 ms just waiting.  beginLater() and beginAll() share a single wait.
+//
+// To move all the waiting out of the static constructors which run
+// before setup(), add this before #include <Encoder.h>, and call
+// Encoder::beginAll() at the start of setup():
+//
+//   #define ENCODER_DEFER_BEGIN
+//
+// If your encoder has no capacitors, the wait may be reduced:
+//
+//   #define ENCODER_SETTLE_MICROSECONDS 0
+
+#include <Encoder.h>
+
+// polled encoders work on any pins, and these are never turned
+BasicEncoder<EncoderPolledTraits> knobs[8];
+const uint8_t num = sizeof(knobs) / sizeof(knobs[0]);
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Boot Time Test:");
+
+  uint32_t t = micros();
+  for (uint8_t i=0; i < num; i++) {
+    knobs[i].begin(2 + i * 2, 3 + i * 2);
+  }
+  t = micros() - t;
+  Serial.print("begin() each:            ");
+  Serial.print(t);
+  Serial.println(" us");
+
+  t = micros();
+  for (uint8_t i=0; i < num; i++) {
+    knobs[i].beginLater(2 + i * 2, 3 + i * 2);
+  }
+  Encoder::beginAll();
+  t = micros() - t;
+  Serial.print("beginLater(), beginAll(): ");
+  Serial.print(t);
+  Serial.println(" us");
+
+  Serial.print("settle time: ");
+  Serial.print(ENCODER_SETTLE_MICROSECONDS);
+  Serial.print(" us, encoders: ");
+  Serial.println(num);
+}
+
+void loop() {
+}
@@ -0,0 +1,41 @@
+/* Encoder Library - Calibration Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Corrects the repeatable error of a rotary disk mounted slightly off
+// center.  The table below came from extras/linux/calibrate.cpp -demo.
+// Make your own from a trace of your encoder against a reference.
+
+#include <Encoder.h>
+#include <EncoderCalibration.h>
+
+// Change these two numbers to the pins connected to your encoder.
+Encoder myEnc(5, 6);
+
+// 4096 counts per revolution, corrections in 1/256 counts
+const EncoderCalibrationPoint calibration[] = {
+  {0, 147}, {384, 804}, {734, 925}, {1793, 254}, {2363, -110},
+  {3121, -1083}, {3449, -1057}, {3808, -499}, {4095, 146},
+};
+EncoderCalibration myAxis(myEnc, calibration, 9, 4096);
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Encoder Calibration Test:");
+}
+
+long oldPosition = -999;
+
+void loop() {
+  long raw = myEnc.read();
+  long corrected = myAxis.readCorrected();
+  if (corrected != oldPosition) {
+    oldPosition = corrected;
+    Serial.print("raw = ");
+    Serial.print(raw);
+    Serial.print(", corrected = ");
+    Serial.println(corrected);
+  }
+}
@@ -0,0 +1,113 @@
+/* Encoder Library - CompareLatency - time from input edge to compare output
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// This benchmark measures how quickly a position compare target drives
+// its output pin.  It generates quadrature signals itself, so connect:
+//
+//    driveA (pin 9)  --->  encoder pin 2
+//    driveB (pin 10) --->  encoder pin 3
+//
+// Each test writes one edge to driveA or driveB, then waits in a tight
+// loop for the compare output to change.  The elapsed time includes the
+// interrupt entry, update() and the compare, which is the latency your
+// machine would see.  The output pin may be watched with a scope too.
+//
+// Cycle counts are used where the CPU has a cycle counter, otherwise
+// micros(), which on AVR only has 4 us resolution.
+
+// Turn on position compare for the plain Encoder class
+#define ENCODER_POSITION_COMPARE
+#include <Encoder.h>
+
+Encoder myEnc(2, 3);
+
+const int driveA = 9;
+const int driveB = 10;
+const int outputPin = 12;
+
+// a target at every count, so each edge fires the output
+const int32_t targets[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+#if defined(ARM_DWT_CYCCNT)
+#define TIMER_NOW() ARM_DWT_CYCCNT
+#define TIMER_UNITS "cycles"
+#elif defined(ESP32) || defined(ESP8266)
+#define TIMER_NOW() ESP.getCycleCount()
+#define TIMER_UNITS "cycles"
+#else
+#define TIMER_NOW() micros()
+#define TIMER_UNITS "us"
+#endif
+
+#if defined(__AVR__) || defined(TEENSYDUINO)
+#define REGTYPE unsigned char
+#else
+#define REGTYPE unsigned long
+#endif
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Compare Latency Test:");
+  pinMode(driveA, OUTPUT);
+  pinMode(driveB, OUTPUT);
+  pinMode(outputPin, OUTPUT);
+  digitalWrite(driveA, LOW);
+  digitalWrite(driveB, LOW);
+  delay(10);
+  myEnc.write(0);
+  myEnc.setCompareTargets(targets, 8);
+  myEnc.setCompareOutput(outputPin, ENCODER_OUTPUT_TOGGLE);
+}
+
+void loop() {
+  volatile REGTYPE *outReg = portInputRegister(digitalPinToPort(outputPin));
+  REGTYPE outMask = digitalPinToBitMask(outputPin);
+  const uint8_t sequence[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+  uint32_t total = 0, worst = 0, count = 0, missed = 0;
+
+  myEnc.write(0);   // the targets above 0 are next again
+  for (int i=0; i < 8; i++) {
+    REGTYPE before = *outReg & outMask;
+    uint32_t begin = TIMER_NOW();
+    // only one of the two signals changes per step
+    if (i & 1) {
+      digitalWrite(driveA, sequence[i & 3][0]);
+    } else {
+      digitalWrite(driveB, sequence[i & 3][1]);
+    }
+    uint32_t elapsed = 0;
+    while ((*outReg & outMask) == before) {
+      elapsed = TIMER_NOW() - begin;
+      if (elapsed > 1000000) break;
+    }
+    if (elapsed > 1000000) {
+      missed++;
+    } else {
+      total += elapsed;
+      if (elapsed > worst) worst = elapsed;
+      count++;
+    }
+  }
+  // return to zero, going backward through the targets
+  for (int i=7; i >= 0; i--) {
+    if (i & 1) {
+      digitalWrite(driveA, sequence[(i + 3) & 3][0]);
+    } else {
+      digitalWrite(driveB, sequence[(i + 3) & 3][1]);
+    }
+    delayMicroseconds(50);
+  }
+  Serial.print("position=");
+  Serial.print(myEnc.read());
+  Serial.print(", average=");
+  Serial.print(count ? total / count : 0);
+  Serial.print(" " TIMER_UNITS ", worst=");
+  Serial.print(worst);
+  Serial.print(" " TIMER_UNITS ", missed=");
+  Serial.println(missed);
+  delay(1000);
+}
@@ -0,0 +1,46 @@
+/* Encoder Library - CounterChips - LS7366R quadrature counters over SPI
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// For encoders too fast for interrupts, LS7366R counter chips count the
+// edges and the board only reads them.  Connect each chip's SCK, MOSI
+// and MISO to the SPI pins, and its SS to one of the pins below.  Give
+// each chip its own crystal or clock (fCKi) as the datasheet shows.
+
+#include <EncoderLS7366.h>
+
+const uint8_t selects[] = {7, 8, 9};   // SS pin of each chip
+const int axes = sizeof(selects);
+
+EncoderLS7366SPI bus(4000000);
+EncoderLS7366<EncoderLS7366SPI, axes> counters(bus, selects);
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("LS7366R Counter Test:");
+  counters.begin(LS7366_X4);
+
+  // how long it takes to read all the chips at once
+  unsigned long begin = micros();
+  for (int i=0; i < 1000; i++) counters.update();
+  Serial.print("update() of all chips: ");
+  Serial.print((micros() - begin) / 1000.0);
+  Serial.println(" us");
+}
+
+void loop() {
+  counters.update();
+  for (int i=0; i < axes; i++) {
+    Serial.print(counters.read(i));
+    Serial.print(i < axes - 1 ? ", " : "\n");
+  }
+  if (Serial.available()) {
+    Serial.read();
+    Serial.println("Reset all to zero");
+    for (int i=0; i < axes; i++) counters.write(i, 0);
+  }
+  delay(100);
+}
@@ -0,0 +1,55 @@
+/* Encoder Library - Cursors Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Two parts of a program each want the movement since they last
+// looked.  readAndReset() would let only one of them see it, so each
+// uses its own EncoderCursor instead.  Type 'h' to home: the position
+// is set to 0, and the cursors still report only real motion.
+
+#define ENCODER_MOVEMENT
+#include <Encoder.h>
+#include <EncoderCursor.h>
+
+// Change these pin numbers to the pins connected to your encoder.
+//   Best Performance: both pins have interrupt capability
+//   Good Performance: only the first pin has interrupt capability
+//   Low Performance:  neither pin has interrupt capability
+Encoder myEnc(5, 6);
+//   avoid using pins with LEDs attached
+
+EncoderCursor fastCursor(myEnc);
+EncoderCursor slowCursor(myEnc);
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Encoder Cursors Test:");
+}
+
+unsigned long lastFast = 0, lastSlow = 0;
+
+void loop() {
+  if (Serial.available() && Serial.read() == 'h') {
+    myEnc.write(0);
+    Serial.println("homed");
+  }
+  // every 10 ms, like a control loop
+  if (millis() - lastFast >= 10) {
+    lastFast += 10;
+    long moved = fastCursor.delta();
+    if (moved) {
+      Serial.print("fast: ");
+      Serial.println(moved);
+    }
+  }
+  // once per second, like a logger
+  if (millis() - lastSlow >= 1000) {
+    lastSlow += 1000;
+    Serial.print("slow: ");
+    Serial.print(slowCursor.delta());
+    Serial.print(", position: ");
+    Serial.println(myEnc.read());
+  }
+}
@@ -0,0 +1,96 @@
+/* Encoder Library - EdgeOverhead - CPU time per counted edge
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// This benchmark measures the CPU time Encoder's interrupt costs for
+// each edge.  It generates quadrature signals itself, so connect:
+//
+//    driveA (pin 18)  --->  encoder pin 4
+//    driveB (pin 19)  --->  encoder pin 5
+//
+// ESP8266 only has GPIO 0 to 16, so there the drive pins are 12 and 13.
+//
+// The same edges are written twice, first before the Encoder is started
+// (no interrupts), then with it counting.  The difference, divided by
+// the number of edges, is the interrupt entry, dispatch and update().
+//
+// On ESP32 and ESP8266 the interrupt is attached with
+// attachInterruptArg(), which passes the Encoder straight to the
+// interrupt routine.  Uncomment ENCODER_NO_ATTACH_ARG to measure the
+// older table lookup through interruptArgs[] for comparison.
+
+//#define ENCODER_NO_ATTACH_ARG
+#include <Encoder.h>
+
+Encoder myEnc;   // started in setup(), after the baseline
+
+#if defined(ESP8266)
+const int driveA = 12;
+const int driveB = 13;
+#else
+const int driveA = 18;
+const int driveB = 19;
+#endif
+const int edges = 4000;
+
+#if defined(ARM_DWT_CYCCNT)
+#define TIMER_NOW() ARM_DWT_CYCCNT
+#define TIMER_UNITS "cycles"
+#elif defined(ESP32) || defined(ESP8266)
+#define TIMER_NOW() ESP.getCycleCount()
+#define TIMER_UNITS "cycles"
+#else
+#define TIMER_NOW() micros()
+#define TIMER_UNITS "us"
+#endif
+
+// write edges, returning the elapsed time
+unsigned long drive() {
+  const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+  noInterrupts();
+  unsigned long begin = TIMER_NOW();
+  interrupts();
+  for (int i=0; i < edges; i++) {
+    digitalWrite(driveA, seq[i & 3][0]);
+    digitalWrite(driveB, seq[i & 3][1]);
+  }
+  return TIMER_NOW() - begin;
+}
+
+unsigned long base;
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Edge Overhead Test:");
+#if defined(ENCODER_ATTACH_ARG)
+  Serial.println("  using attachInterruptArg()");
+#else
+  Serial.println("  using interruptArgs[] table");
+#endif
+  pinMode(driveA, OUTPUT);
+  pinMode(driveB, OUTPUT);
+  digitalWrite(driveA, LOW);
+  digitalWrite(driveB, LOW);
+  // baseline, before the Encoder attaches its interrupts
+  base = drive();
+  myEnc.begin(4, 5);
+}
+
+void loop() {
+  myEnc.write(0);
+  unsigned long counting = drive();
+  long count = myEnc.read();
+
+  // each step of the sequence changes 1 pin, so 1 edge per step
+  Serial.print("edges: ");
+  Serial.print(count);
+  Serial.print(" (expected ");
+  Serial.print(edges);
+  Serial.print("), per edge: ");
+  Serial.print((float)(counting - base) / edges);
+  Serial.println(" " TIMER_UNITS);
+  delay(2000);
+}
@@ -0,0 +1,72 @@
+/* Encoder Library - Footprint - memory used by the interrupt tables
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Normally Encoder has a table with 1 pointer for every interrupt the
+// board has (CORE_NUM_INTERRUPT), and 1 small interrupt routine for
+// each interrupt capable pin.  ENCODER_INTERRUPT_SLOTS sizes the table
+// and the routines for the number of interrupt pins you actually use,
+// 2 per encoder, at 1 extra byte per slot plus 1 for the count.
+//
+// Interrupt table RAM for this sketch, 3 encoders, per BasicEncoder type:
+//
+//   board              interrupts  normal    ENCODER_INTERRUPT_SLOTS 6
+//   Arduino Uno             2         4 bytes    19 bytes
+//   Arduino Leonardo        5        10          19
+//   Arduino Mega            6        12          19
+//   Arduino Zero           31       124          31
+//   Arduino Due            54       216          31
+//   Teensy 3.6             64       256          31
+//   Teensy 4.1             55       220          31
+//   Arduino Giga           76       304          31
+//
+// Flash goes the same way: 1 routine per interrupt capable pin normally,
+// 6 with the slots.  Each is a call to update(), or a copy of it where
+// the compiler inlines it, so the bytes depend on the board and compiler
+// version.  So on boards with few interrupts the slots cost more than
+// they save, and only help on the 32 bit boards.  ESP32 and ESP8266 pass
+// the encoder to attachInterruptArg() and have no table at all.
+//
+// Upload this twice, with and without the #define below, and compare
+// what it prints.  For flash, compare the "Sketch uses ... bytes"
+// message from Arduino after each compile.
+//
+// If more pins are used than there are slots, the extra pins get no
+// interrupt and those encoders are updated when read(), like pins
+// without interrupt capability.
+
+//#define ENCODER_INTERRUPT_SLOTS 6
+
+#include <Encoder.h>
+
+Encoder knob1(2, 3);
+Encoder knob2(4, 5);
+Encoder knob3(6, 7);
+//   change these to interrupt pins on your board
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Footprint:");
+  Serial.print("  interrupts on this board:   ");
+  Serial.println(CORE_NUM_INTERRUPT);
+#ifdef ENCODER_INTERRUPT_SLOTS
+  Serial.print("  ENCODER_INTERRUPT_SLOTS:    ");
+  Serial.println(ENCODER_INTERRUPT_SLOTS);
+  // plus 1 byte per slot to map it back to its interrupt, and a count
+  int ram = sizeof(Encoder::interruptArgs) + ENCODER_INTERRUPT_SLOTS + 1;
+#else
+  int ram = sizeof(Encoder::interruptArgs);
+#endif
+  Serial.print("  interrupt table RAM:        ");
+  Serial.print(ram);
+  Serial.println(" bytes");
+  Serial.print("  RAM per Encoder:            ");
+  Serial.print(sizeof(Encoder));
+  Serial.println(" bytes");
+}
+
+void loop() {
+}
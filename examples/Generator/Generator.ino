@@ -0,0 +1,58 @@
+/* Encoder Library - Generator - loopback test with generated signals
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Instead of a flip-flop and 555 timer circuit (see SpeedTest), this
+// test generates the quadrature signals in software.  Connect:
+//
+//    pin 9   --->  encoder pin 2
+//    pin 10  --->  encoder pin 3
+//
+// Each pass sweeps the speed up, adding bounce and jitter, then prints
+// the true position beside Encoder's count.  The same seed always gives
+// the same signal, so results can be compared between boards and
+// settings.  The highest speed is limited by how quickly loop() runs
+// EncoderSignalOutput::update().
+
+#include <Encoder.h>
+#include <EncoderGenerator.h>
+
+Encoder myEnc(2, 3);
+
+EncoderSignalGenerator generator;
+EncoderSignalOutput output;
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Generator Test:");
+  pinMode(9, OUTPUT);
+  pinMode(10, OUTPUT);
+}
+
+uint32_t pass = 0;
+
+void loop() {
+  // 100 to 5000 counts/sec over 2 seconds
+  generator.setSweep(100, 5000, 2000000);
+  generator.setJitter(20000);
+  generator.setBounce(0.1, 2, 20000);
+  generator.seed(++pass);
+  // the generator starts with both signals low
+  digitalWrite(9, LOW);
+  digitalWrite(10, LOW);
+  delay(1);
+  myEnc.write(0);
+  output.begin(generator, 9, 10);
+  while (output.update()) ;
+  delay(1);
+  Serial.print("pass ");
+  Serial.print(pass);
+  Serial.print(": true position ");
+  Serial.print(generator.position());
+  Serial.print(", counted ");
+  Serial.println(myEnc.read());
+  delay(500);
+}
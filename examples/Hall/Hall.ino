@@ -0,0 +1,44 @@
+/* Encoder Library - Hall Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Decode the 3 Hall sensors of a brushless motor.  Turn the motor by
+// hand and watch the position, commutation sector and invalid count.
+
+#include <EncoderHall.h>
+
+// Change these to the pins connected to Hall sensors A, B and C.
+// All 3 should have interrupt capability.
+EncoderHall motor(5, 6, 7);
+
+// for position in shaft revolutions
+const int polePairs = 4;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Hall Sensor Test:");
+}
+
+long oldPosition = -999;
+
+void loop() {
+  long newPosition = motor.read();
+  if (newPosition != oldPosition) {
+    oldPosition = newPosition;
+    uint8_t sector = motor.sector();
+    Serial.print("position = ");
+    Serial.print(newPosition);
+    Serial.print(" (");
+    Serial.print((float)newPosition / (6 * polePairs));
+    Serial.print(" rev), sector = ");
+    if (sector == ENCODER_HALL_NO_SECTOR) {
+      Serial.print("none");
+    } else {
+      Serial.print(sector);
+    }
+    Serial.print(", invalid = ");
+    Serial.println(motor.invalid());
+  }
+}
@@ -0,0 +1,47 @@
+/* Encoder Library - HardwareCounter Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// On ESP32 (PCNT) and Teensy 4.x (ENC), the chip itself can count
+// quadrature, using no CPU time per edge.  EncoderCounter works like
+// Encoder, and both may be used together.
+
+#include <EncoderCounter.h>
+
+// ESP32: PCNT unit 0 to 7, any input pins.
+// Teensy 4: ENC module 1 to 4, pins 0-5, 7 or 8.
+#if defined(ESP32)
+EncoderCounter fast(0);
+#else
+EncoderCounter fast(1);
+#endif
+
+// an ordinary interrupt based encoder beside it
+Encoder knob(5, 6);
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Hardware Counter Test:");
+  if (!fast.begin(2, 3)) {
+    Serial.println("These pins can not be used with this counter");
+  }
+}
+
+long oldFast = -999, oldKnob = -999;
+
+void loop() {
+  // with a 16 bit counter (ESP32), read at least every 16000 counts
+  long f = fast.read();
+  long k = knob.read();
+  if (f != oldFast || k != oldKnob) {
+    Serial.print("counter = ");
+    Serial.print(f);
+    Serial.print(", knob = ");
+    Serial.println(k);
+    oldFast = f;
+    oldKnob = k;
+  }
+}
@@ -0,0 +1,88 @@
+/* Encoder Library - HistoryBench - cost of recording position history
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// This benchmark measures what EncoderHistory costs on your board: the
+// extra interrupt time per count when every count is recorded, and the
+// time to look up a position by time.  It generates quadrature signals
+// itself, so connect:
+//
+//    driveA (pin 18)  --->  encoder pin 4
+//    driveB (pin 19)  --->  encoder pin 5
+//
+// The same edges are written with the history off and on.  The
+// difference, divided by the number of edges, is the cost of recording.
+
+#define ENCODER_HISTORY
+#include <EncoderHistory.h>
+
+Encoder myEnc(4, 5);
+EncoderHistory<256> history;   // 2 kbytes
+
+const int driveA = 18;
+const int driveB = 19;
+const int edges = 4000;
+
+#if defined(ARM_DWT_CYCCNT)
+#define TIMER_NOW() ARM_DWT_CYCCNT
+#define TIMER_UNITS "cycles"
+#elif defined(ESP32) || defined(ESP8266)
+#define TIMER_NOW() ESP.getCycleCount()
+#define TIMER_UNITS "cycles"
+#else
+#define TIMER_NOW() micros()
+#define TIMER_UNITS "us"
+#endif
+
+// write edges, returning the elapsed time
+unsigned long drive() {
+  const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+  unsigned long begin = TIMER_NOW();
+  for (int i=0; i < edges; i++) {
+    digitalWrite(driveA, seq[i & 3][0]);
+    digitalWrite(driveB, seq[i & 3][1]);
+  }
+  return TIMER_NOW() - begin;
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder History Benchmark:");
+  pinMode(driveA, OUTPUT);
+  pinMode(driveB, OUTPUT);
+  digitalWrite(driveA, LOW);
+  digitalWrite(driveB, LOW);
+}
+
+void loop() {
+  myEnc.setHistory(0);
+  unsigned long off = drive();
+  myEnc.setHistory(&history);
+  unsigned long on = drive();
+  Serial.print("recording per count: ");
+  Serial.print(((float)on - (float)off) / edges);
+  Serial.println(" " TIMER_UNITS);
+
+  // look up times spread over everything recorded
+  uint32_t first = history.oldest();
+  uint32_t span = micros() - first;
+  float p, sum = 0;
+  const int lookups = 1000;
+  unsigned long begin = TIMER_NOW();
+  for (int i=0; i < lookups; i++) {
+    if (history.positionAt(first + span / lookups * i, p)) sum += p;
+  }
+  unsigned long elapsed = TIMER_NOW() - begin;
+  Serial.print("positionAt(): ");
+  Serial.print((float)elapsed / lookups);
+  Serial.print(" " TIMER_UNITS ", ");
+  Serial.print(history.count());
+  Serial.print(" entries over ");
+  Serial.print(span);
+  Serial.println(" us");
+  if (sum == 12345) Serial.println();   // keep the lookups
+  delay(2000);
+}
@@ -0,0 +1,49 @@
+/* Encoder Library - Journal Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Keeps the position in EEPROM, so it survives turning the power off.
+// Turn the knob, wait a moment for it to be saved, then reset or power
+// cycle the board: the position continues from where it was.
+
+#include <Encoder.h>
+#include <EncoderJournal.h>
+
+// Change these two numbers to the pins connected to your encoder.
+Encoder myEnc(5, 6);
+
+// 8 sectors of 64 bytes from EEPROM address 0: 13 records per sector,
+// so each EEPROM byte is written twice, the record then its erase,
+// per 104 saves.
+EncoderJournalEEPROM store(0, 64, 8);
+EncoderJournal journal(myEnc, store);
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Journal Test:");
+  if (journal.begin()) {
+    Serial.print("restored position ");
+    Serial.println(myEnc.read());
+  } else {
+    Serial.println("no saved position, starting from 0");
+  }
+  // save half a second after the knob stops
+  journal.setPolicy(500, 0);
+}
+
+long oldPosition = -999;
+
+void loop() {
+  if (journal.update()) {
+    Serial.print("saved ");
+    Serial.println(journal.savedPosition());
+  }
+  long newPosition = myEnc.read();
+  if (newPosition != oldPosition) {
+    oldPosition = newPosition;
+    Serial.println(newPosition);
+  }
+}
@@ -0,0 +1,65 @@
+/* Encoder Library - Monitor Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// ENCODER_TRACK_MOTION makes Encoder record the time and direction
+// of every count.  It must be defined before Encoder.h is included.
+#define ENCODER_TRACK_MOTION
+#include <Encoder.h>
+#include <EncoderMonitor.h>
+
+// Change these two numbers to the pins connected to your encoder.
+//   Best Performance: both pins have interrupt capability
+//   Good Performance: only the first pin has interrupt capability
+//   Low Performance:  neither pin has interrupt capability
+Encoder myEnc(5, 6);
+//   avoid using pins with LEDs attached
+
+EncoderMonitor monitor(myEnc);
+
+volatile bool stallFlag, reverseFlag, overspeedFlag;
+
+void stall() { stallFlag = true; }
+void reverse() { reverseFlag = true; }
+void overspeed() { overspeedFlag = true; }
+
+#if defined(TEENSYDUINO)
+// On Teensy, check from a timer so detection does not depend on loop()
+IntervalTimer monitorTimer;
+void checkMonitor() { monitor.check(); }
+#endif
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Encoder Monitor Test:");
+  monitor.setStallTimeout(250000);    // 250 ms without a count
+  monitor.setOverspeedInterval(100);  // faster than 10000 counts/sec
+  monitor.onStall(stall);
+  monitor.onReverse(reverse);
+  monitor.onOverspeed(overspeed);
+#if defined(TEENSYDUINO)
+  monitorTimer.begin(checkMonitor, 10000);
+#endif
+}
+
+void loop() {
+#if !defined(TEENSYDUINO)
+  monitor.check();
+#endif
+  if (stallFlag) {
+    stallFlag = false;
+    Serial.print("Stall at ");
+    Serial.println(myEnc.read());
+  }
+  if (reverseFlag) {
+    reverseFlag = false;
+    Serial.print("Reverse, now moving ");
+    Serial.println(monitor.direction() > 0 ? "forward" : "backward");
+  }
+  if (overspeedFlag) {
+    overspeedFlag = false;
+    Serial.println("Overspeed");
+  }
+}
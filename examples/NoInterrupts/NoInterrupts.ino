@@ -10,6 +10,9 @@
 // with pins that do not support interrupts.  Without interrupts,
 // your program must call the read() function rapidly, or risk
 // missing changes in position.
+//
+// To poll only some encoders while others use interrupts, leave this
+// undefined and use BasicEncoder<EncoderPolledTraits> for the polled ones.
 #define ENCODER_DO_NOT_USE_INTERRUPTS
 #include <Encoder.h>
 
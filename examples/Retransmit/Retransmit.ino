@@ -0,0 +1,127 @@
+/* Encoder Library - Retransmit - quadrature output latency and divider
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// This benchmark measures how quickly setRetransmit() passes each count
+// through to its quadrature output pins, and checks the divider.  It
+// generates quadrature signals itself, so connect:
+//
+//    driveA (pin 9)  --->  encoder pin 2
+//    driveB (pin 10) --->  encoder pin 3
+//
+// and watch outA (pin 5) and outB (pin 6) with a scope or another
+// encoder if you like.  Each test writes one edge to driveA or driveB,
+// then waits in a tight loop for an output pin to change.  The elapsed
+// time includes the interrupt entry and update(), which is the latency
+// the next machine in the chain would see.  Then the same steps are
+// repeated with a divide by 4, which should give 1 output edge for
+// every 4 input counts.
+//
+// Cycle counts are used where the CPU has a cycle counter, otherwise
+// micros(), which on AVR only has 4 us resolution.
+
+// Turn on retransmit for the plain Encoder class
+#define ENCODER_RETRANSMIT
+#include <Encoder.h>
+
+Encoder myEnc(2, 3);
+
+const int driveA = 9;
+const int driveB = 10;
+const int outA = 5;
+const int outB = 6;
+
+#if defined(ARM_DWT_CYCCNT)
+#define TIMER_NOW() ARM_DWT_CYCCNT
+#define TIMER_UNITS "cycles"
+#elif defined(ESP32) || defined(ESP8266)
+#define TIMER_NOW() ESP.getCycleCount()
+#define TIMER_UNITS "cycles"
+#else
+#define TIMER_NOW() micros()
+#define TIMER_UNITS "us"
+#endif
+
+const uint8_t sequence[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Retransmit Test:");
+  pinMode(driveA, OUTPUT);
+  pinMode(driveB, OUTPUT);
+  pinMode(outA, OUTPUT);
+  pinMode(outB, OUTPUT);
+  digitalWrite(driveA, LOW);
+  digitalWrite(driveB, LOW);
+  delay(10);
+}
+
+uint8_t outputs() {
+  return (digitalRead(outA) << 1) | digitalRead(outB);
+}
+
+// one input step, forward for i = 0 to 7, back for i = 7 to 0
+void step(int i, bool forward) {
+  int s = forward ? i : i + 3;
+  if (i & 1) {
+    digitalWrite(driveA, sequence[s & 3][0]);
+  } else {
+    digitalWrite(driveB, sequence[s & 3][1]);
+  }
+}
+
+void loop() {
+  uint32_t total = 0, worst = 0, count = 0, missed = 0;
+
+  myEnc.write(0);
+  myEnc.setRetransmit(outA, outB);
+  for (int i=0; i < 8; i++) {
+    uint8_t before = outputs();
+    uint32_t begin = TIMER_NOW();
+    step(i, true);
+    uint32_t elapsed = 0;
+    while (outputs() == before) {
+      elapsed = TIMER_NOW() - begin;
+      if (elapsed > 1000000) break;
+    }
+    if (elapsed > 1000000) {
+      missed++;
+    } else {
+      total += elapsed;
+      if (elapsed > worst) worst = elapsed;
+      count++;
+    }
+  }
+  for (int i=7; i >= 0; i--) {
+    step(i, false);
+    delayMicroseconds(50);
+  }
+
+  // divide by 4: 8 counts forward and back are 2 output edges each way
+  int edges = 0;
+  myEnc.setRetransmit(outA, outB, 1, 4);
+  for (int pass=0; pass < 2; pass++) {
+    for (int n=0; n < 8; n++) {
+      int i = pass ? 7 - n : n;
+      uint8_t before = outputs();
+      step(i, pass == 0);
+      delayMicroseconds(50);
+      if (outputs() != before) edges++;
+    }
+  }
+  Serial.print("position=");
+  Serial.print(myEnc.read());
+  Serial.print(", average=");
+  Serial.print(count ? total / count : 0);
+  Serial.print(" " TIMER_UNITS ", worst=");
+  Serial.print(worst);
+  Serial.print(" " TIMER_UNITS ", missed=");
+  Serial.print(missed);
+  Serial.print(", divide by 4 edges=");
+  Serial.print(edges);
+  Serial.println(" (should be 4)");
+  delay(1000);
+}
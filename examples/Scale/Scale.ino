@@ -0,0 +1,67 @@
+/* Encoder Library - Scale - counts to units without float
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Shows the position of a linear scale in um and its speed in um/sec,
+// using EncoderScale's fixed point conversion, and compares the time of
+// 1000 conversions with the same math in float.
+
+#include <Encoder.h>
+#include <EncoderScale.h>
+
+// Change these two numbers to the pins connected to your encoder.
+Encoder myEnc(5, 6);
+
+// A 2.5 um per count linear scale, velocity sampled every 10 ms
+typedef EncoderRatio<5, 2> Microns;
+BasicEncoderScale<Encoder, Microns, 10000> myAxis(myEnc);
+
+#if defined(ARM_DWT_CYCCNT)
+#define TIMER_NOW() ARM_DWT_CYCCNT
+#define TIMER_UNITS "cycles"
+#elif defined(ESP32) || defined(ESP8266)
+#define TIMER_NOW() ESP.getCycleCount()
+#define TIMER_UNITS "cycles"
+#else
+#define TIMER_NOW() micros()
+#define TIMER_UNITS "us"
+#endif
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Scale Test:");
+
+  volatile int32_t sink = 0;
+  unsigned long begin = TIMER_NOW();
+  for (int32_t i=0; i < 1000; i++) sink += Microns::convert(i * 37 - 5000);
+  unsigned long fixed = TIMER_NOW() - begin;
+  begin = TIMER_NOW();
+  for (int32_t i=0; i < 1000; i++) sink += (int32_t)floorf((i * 37 - 5000) * 2.5f);
+  unsigned long floating = TIMER_NOW() - begin;
+  Serial.print("1000 conversions: fixed point ");
+  Serial.print(fixed);
+  Serial.print(" " TIMER_UNITS ", float ");
+  Serial.print(floating);
+  Serial.println(" " TIMER_UNITS);
+}
+
+unsigned long lastSample = 0;
+int32_t oldPosition = -999;
+
+void loop() {
+  if (micros() - lastSample >= 10000) {
+    lastSample += 10000;
+    myAxis.sample();
+  }
+  int32_t um = myAxis.read();
+  if (um != oldPosition) {
+    oldPosition = um;
+    Serial.print(um);
+    Serial.print(" um, ");
+    Serial.print(myAxis.readVelocity());
+    Serial.println(" um/sec");
+  }
+}
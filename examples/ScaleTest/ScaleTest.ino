@@ -0,0 +1,149 @@
+/* Encoder Library - ScaleTest - throughput with many encoders at once
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// This benchmark finds how fast edges may arrive as more encoders are
+// added.  It generates quadrature signals itself, and every encoder
+// gets the same signals, the worst case where all their interrupts are
+// requested at once.  Connect:
+//
+//    driveA (pin 9)  --->  first pin of every encoder
+//    driveB (pin 10) --->  second pin of every encoder
+//
+// The encoders use the interrupt pins in pairs, from the lowest number,
+// up to 30 encoders.  Pins 0 and 1 (Serial on many boards) and the
+// drive pins are skipped.  Boards with fewer interrupt pins stop sooner,
+// and the limit is printed at the start: 1 on Uno and Leonardo, 3 on
+// Mega, 25 on Due and Teensy 4.1, 30 on Teensy 3.6.  To wire fewer, set
+// maxEncoders to the number connected: encoders on pins not driven
+// stay still and count wrong.
+//
+// For 1 encoder, then 2, 3 ... all of them, the time between edges is
+// shortened until any encoder's count is wrong.  A wrong count means an
+// interrupt was still pending when the next edge came (a +/-2 step).
+// Printed for each number of encoders:
+//
+//   gap       shortest time between edges (us) with all counts right
+//   edges/s   aggregate, edges per second times number of encoders
+//   cost      CPU time of all the interrupts for 1 edge, measured like
+//             EdgeOverhead.  The last encoder waits about this long for
+//             its interrupt, the worst case latency.
+//   misses    encoders counting wrong at the next shorter gap
+//
+// extras/linux/scale_bench.cpp models the same thing on a PC, with
+// independent signals and your own interrupt timing.
+
+#include <Encoder.h>
+
+const int maxEncoders = 30;
+Encoder enc[maxEncoders];   // started one at a time in loop()
+uint8_t pin1[maxEncoders], pin2[maxEncoders];
+int numEncoders = 0;        // as many as this board has pins for
+
+const int driveA = 9;
+const int driveB = 10;
+const int edges = 2000;
+
+#if defined(ARM_DWT_CYCCNT)
+#define TIMER_NOW() ARM_DWT_CYCCNT
+#define TIMER_UNITS "cycles"
+#elif defined(ESP32) || defined(ESP8266)
+#define TIMER_NOW() ESP.getCycleCount()
+#define TIMER_UNITS "cycles"
+#else
+#define TIMER_NOW() micros()
+#define TIMER_UNITS "us"
+#endif
+
+// write edges with gap us between them, returning the elapsed time
+unsigned long drive(int count, unsigned int gap) {
+  const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+  unsigned long begin = TIMER_NOW();
+  for (int i=0; i < count; i++) {
+    // only one of the two signals changes per step
+    if (i & 1) {
+      digitalWrite(driveA, seq[i & 3][0]);
+    } else {
+      digitalWrite(driveB, seq[i & 3][1]);
+    }
+    if (gap) delayMicroseconds(gap);
+  }
+  return TIMER_NOW() - begin;
+}
+
+// how many of the first n encoders count wrong at this gap
+int misses(int n, unsigned int gap) {
+  for (int i=0; i < n; i++) enc[i].write(0);
+  drive(edges, gap);
+  delayMicroseconds(100);   // let the last interrupts finish
+  int wrong = 0;
+  for (int i=0; i < n; i++) {
+    if (labs(enc[i].read()) != edges) wrong++;
+  }
+  return wrong;
+}
+
+unsigned long base;
+int running = 0;
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("Encoder Scalability Test:");
+  // pair up the pins Encoder has an interrupt for
+  int found = 0;
+  for (int pin=2; pin < NUM_DIGITAL_PINS && numEncoders < maxEncoders; pin++) {
+    if (pin == driveA || pin == driveB) continue;
+    int irq = digitalPinToInterrupt(pin);
+    if (irq < 0 || irq >= CORE_NUM_INTERRUPT) continue;
+    if (found++ & 1) {
+      pin2[numEncoders++] = pin;
+    } else {
+      pin1[numEncoders] = pin;
+    }
+  }
+  Serial.print("up to ");
+  Serial.print(numEncoders);
+  Serial.println(" encoders on this board");
+  pinMode(driveA, OUTPUT);
+  pinMode(driveB, OUTPUT);
+  digitalWrite(driveA, LOW);
+  digitalWrite(driveB, LOW);
+  // baseline, before any interrupts are attached
+  base = drive(edges, 0);
+  Serial.println("encoders  gap  edges/s  cost (" TIMER_UNITS ")  misses");
+}
+
+void loop() {
+  if (running >= numEncoders) return;
+  enc[running].begin(pin1[running], pin2[running]);
+  running++;
+  // drive() ends with both signals low, where every encoder started
+
+  unsigned long cost = drive(edges, 0) - base;
+  unsigned int gap = 1024;
+  int over = 0;
+  while (gap > 0) {
+    over = misses(running, gap / 2);
+    if (over) break;
+    gap /= 2;
+  }
+
+  Serial.print(running);
+  Serial.print("  ");
+  Serial.print(gap);
+  Serial.print("  ");
+  if (gap) {
+    Serial.print(1000000.0 / gap * running, 0);
+  } else {
+    // no delay at all still counts right: as fast as drive() runs
+    Serial.print("max");
+  }
+  Serial.print("  ");
+  Serial.print((float)cost / edges);
+  Serial.print("  ");
+  Serial.println(over);
+  delay(500);
+}
@@ -0,0 +1,75 @@
+/* Encoder Library - ShiftScan - many knobs through 74HC165 chips
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// 48 knobs read through a chain of 12 74HC165 shift registers, using
+// SPI and 1 load pin.  See EncoderShift.h for the wiring.
+//
+// setup() first measures how long a scan takes.  Each knob must be seen
+// in every state, so a knob may turn at most 1 count per scan: at
+// 20000 scans/sec, a 24 detent (96 count) knob may spin 200 times per
+// second, far beyond any hand.  Mechanical knobs bounce, so a higher
+// scan rate than needed is still useful.
+
+#include <EncoderShift.h>
+
+const int knobs = 48;
+
+EncoderShiftSPI bus(10);   // SH/LD pin
+EncoderShift<EncoderShiftSPI, knobs> scanner(bus);
+
+long shown[knobs];
+
+#if defined(TEENSYDUINO)
+IntervalTimer timer;
+
+void scan() {
+  scanner.scan();
+}
+#endif
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ;
+  Serial.println("EncoderShift Scan Test:");
+  scanner.begin();
+
+  const int count = 2000;
+  unsigned long begin = micros();
+  for (int i=0; i < count; i++) scanner.scan();
+  unsigned long elapsed = micros() - begin;
+  Serial.print("scan time: ");
+  Serial.print((float)elapsed / count);
+  Serial.print(" us, ");
+  Serial.print(1000000.0 * count / elapsed, 0);
+  Serial.print(" scans/sec, ");
+  Serial.print(1000000.0 * count / elapsed * knobs, 0);
+  Serial.println(" encoder samples/sec");
+  for (int i=0; i < knobs; i++) scanner.write(i, 0);
+#if defined(TEENSYDUINO)
+  timer.begin(scan, 100);   // every 100 us
+#endif
+}
+
+void loop() {
+#if !defined(TEENSYDUINO)
+  // without a timer library, scan every 100 us from loop(), which must
+  // not be busy for longer than 1 count of the fastest knob
+  static unsigned long last = 0;
+  if (micros() - last < 100) return;
+  last = micros();
+  scanner.scan();
+#endif
+  for (int i=0; i < knobs; i++) {
+    long n = scanner.read(i);
+    if (n != shown[i]) {
+      shown[i] = n;
+      Serial.print("knob ");
+      Serial.print(i);
+      Serial.print(" = ");
+      Serial.println(n);
+    }
+  }
+}
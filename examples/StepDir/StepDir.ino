@@ -0,0 +1,48 @@
+/* Encoder Library - StepDir Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Count step/direction signals, like those sent to a stepper driver,
+// and separate up/down (CW/CCW) pulse trains, with the same fast
+// interrupts as quadrature.  The mode is chosen by begin() or the
+// constructor, so quadrature encoders may be mixed in freely.
+
+// Turn on the extra decode modes for the plain Encoder class
+#define ENCODER_PULSE_MODES
+#include <Encoder.h>
+
+// Step on pin 2, direction on pin 3 (high = forward).  Only the step
+// pin needs interrupt capability.
+Encoder stepper(2, 3, ENCODER_STEP_DIR);
+
+// Up pulses on pin 18, down pulses on pin 19.  Both count on rising edges.
+Encoder upDown(18, 19, ENCODER_UP_DOWN);
+
+// an ordinary quadrature knob
+Encoder knob(5, 6);
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println("Step/Direction Encoder Test:");
+}
+
+long oldStepper = -999, oldUpDown = -999, oldKnob = -999;
+
+void loop() {
+  long s = stepper.read();
+  long u = upDown.read();
+  long k = knob.read();
+  if (s != oldStepper || u != oldUpDown || k != oldKnob) {
+    Serial.print("steps = ");
+    Serial.print(s);
+    Serial.print(", up/down = ");
+    Serial.print(u);
+    Serial.print(", knob = ");
+    Serial.println(k);
+    oldStepper = s;
+    oldUpDown = u;
+    oldKnob = k;
+  }
+}
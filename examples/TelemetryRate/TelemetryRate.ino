@@ -0,0 +1,83 @@
+/* Encoder Library - TelemetryRate - binary stream size and speed
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// This benchmark measures how many position samples per second a serial
+// link carries with EncoderTelemetry, compared to printing the positions
+// as text.  Turn the knobs while it runs: faster motion needs more bytes
+// per frame.
+//
+// At each baud rate, frames are sent as fast as possible for 1 second on
+// a hardware serial port (Serial1, or Serial on boards with only one),
+// then the same samples as text, and the number which actually went out
+// is counted.  write() waits while the transmit buffer is full, so this
+// is the real rate the port sustains, including the CPU time to read the
+// encoders and build each frame.  Nothing needs to be connected to the
+// port, but a receiver may be, running EncoderTelemetryDecoder.
+//
+// Results are printed on Serial.  USB serial on Teensy and others runs at
+// full USB speed whatever baud is set, so it is not used for the test.
+
+#include <Encoder.h>
+#include <EncoderTelemetry.h>
+
+Encoder knob1(5, 6);
+Encoder knob2(7, 8);
+//   avoid using pins with LEDs attached
+
+#if defined(__AVR__) && !defined(HAVE_HWSERIAL1)
+#define LINK Serial        // Uno and similar, results share the port
+#else
+#define LINK Serial1
+#endif
+
+EncoderTelemetry telemetry(LINK);
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("Encoder Telemetry Rate Test:");
+  telemetry.add(knob1);
+  telemetry.add(knob2);
+}
+
+// send for about 1 second at a baud rate, printing samples per second
+void measure(uint32_t baud, bool binary) {
+  LINK.begin(baud);
+  uint32_t samples = 0, bytes = 0;
+  uint32_t begin = millis();
+  while (millis() - begin < 1000) {
+    if (binary) {
+      bytes += telemetry.send();
+    } else {
+      // the way the other examples print positions
+      bytes += LINK.println(knob1.read());
+      bytes += LINK.println(knob2.read());
+    }
+    samples += 2;
+  }
+  LINK.flush();    // until the last byte has gone out
+  uint32_t elapsed = millis() - begin;
+#if defined(__AVR__) && !defined(HAVE_HWSERIAL1)
+  Serial.begin(115200);
+#endif
+  Serial.print(binary ? "binary " : ", text ");
+  Serial.print(samples * 1000 / elapsed);
+  Serial.print(" samples/sec (");
+  Serial.print((float)bytes * 2 / samples);
+  Serial.print(" bytes per 2 axes)");
+}
+
+void loop() {
+  const uint32_t bauds[] = {9600, 57600, 115200, 460800, 921600};
+  for (unsigned int i=0; i < sizeof(bauds) / sizeof(bauds[0]); i++) {
+    Serial.print(bauds[i]);
+    Serial.print(" baud: ");
+    Serial.flush();
+    measure(bauds[i], true);
+    measure(bauds[i], false);
+    Serial.println();
+  }
+  delay(2000);
+}
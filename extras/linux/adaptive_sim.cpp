@@ -0,0 +1,129 @@
+/* Encoder Library - EncoderAdaptive crossover simulation
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Runs Encoder and EncoderAdaptive on the host, with simulated edges and
+// timer ticks in simulated time, to find where timer polling becomes
+// cheaper than interrupts and to check that no counts are lost when
+// EncoderAdaptive switches modes.
+//
+// CPU time is counted with a cost per call, since host timing says
+// little about a microcontroller.  The defaults are rough numbers for a
+// 96 MHz Cortex-M4; give your own measurements on the command line.
+//
+//   g++ -O2 -I../.. adaptive_sim.cpp -o adaptive_sim
+//   ./adaptive_sim [tickHz] [isrCycles] [pollCycles] [tickCycles] [cpuHz]
+
+#include <EncoderAdaptive.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LINE_A 2
+#define LINE_B 3
+
+struct Costs {
+	uint32_t tick_hz, isr, poll, tick, cpu_hz;
+	uint32_t high, low;
+};
+
+struct Result {
+	double load;		// fraction of CPU time
+	uint32_t edges;
+	int32_t position;
+	uint32_t switches;
+};
+
+static void edge(uint32_t n) {
+	// levels of A and B, 1 step forward per edge
+	static const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+	volatile uint8_t *levels = encoder_linux_levels();
+	const uint8_t *now = seq[n & 3];
+	uint8_t line = (levels[LINE_A] != now[0]) ? LINE_A : LINE_B;
+	levels[line] = (line == LINE_A) ? now[0] : now[1];
+	encoder_linux_isr_t isr = encoder_linux_vectors()[line];
+	if (isr) (*isr)(line);
+}
+
+// mode 0: interrupts only, 1: polling only, 2: adaptive
+// rate(t) gives the edge rate at time t seconds
+static Result run(const Costs &c, int mode, double seconds, double (*rate)(double)) {
+	encoder_linux_levels()[LINE_A] = 0;
+	encoder_linux_levels()[LINE_B] = 0;
+	Encoder enc;
+	enc.begin(LINE_A, LINE_B);
+	EncoderAdaptive adapt(enc, LINE_A, LINE_B, c.tick_hz);
+	adapt.setThresholds(c.high, c.low);
+	if (mode == 1) enc.detachInterrupts(LINE_A, LINE_B);
+	// each tick period, the edges due in it come first, evenly spaced
+	double cycles = 0, due = 0, dt = 1.0 / c.tick_hz;
+	uint32_t edges = 0;
+	for (double t = 0; t < seconds; t += dt) {
+		due += rate(t) * dt;
+		while (due >= 1.0) {
+			due -= 1.0;
+			if (encoder_linux_vectors()[LINE_A]) cycles += c.isr;
+			edge(edges++);
+		}
+		if (mode == 1) {
+			enc.poll();
+			cycles += c.poll;
+		} else if (mode == 2) {
+			cycles += adapt.polling() ? c.poll : c.tick;
+			adapt.tick();
+			adapt.update();		// loop() between ticks
+		}
+	}
+	enc.poll();
+	Result res;
+	res.load = cycles / (seconds * c.cpu_hz);
+	res.edges = edges;
+	res.position = enc.read();
+	res.switches = adapt.switches;
+	return res;
+}
+
+static double fixed_rate;
+static double constant(double t) { return fixed_rate; }
+// 0 to peak and back, over 2 seconds
+static double peak;
+static double ramp(double t) { return (t < 1.0) ? peak * t : peak * (2.0 - t); }
+
+int main(int argc, char **argv) {
+	Costs c;
+	c.tick_hz = (argc > 1) ? atoi(argv[1]) : 20000;
+	c.isr = (argc > 2) ? atoi(argv[2]) : 90;
+	c.poll = (argc > 3) ? atoi(argv[3]) : 60;
+	c.tick = (argc > 4) ? atoi(argv[4]) : 20;
+	c.cpu_hz = (argc > 5) ? atoi(argv[5]) : 96000000;
+	// switch a little either side of the crossover, but never above
+	// 90%% of the tick rate, where polling would start to miss counts
+	double cross = (double)c.tick_hz * c.poll / c.isr;
+	c.high = (cross * 1.1 < c.tick_hz * 0.9) ? cross * 1.1 : c.tick_hz * 0.9;
+	c.low = c.high * 0.8;
+	printf("tick %u Hz, isr %u, poll %u, idle tick %u cycles, cpu %u Hz\n",
+		c.tick_hz, c.isr, c.poll, c.tick, c.cpu_hz);
+	printf("\n  edges/sec   interrupts    polling   adaptive   lost\n");
+	double crossover = 0;
+	for (int i=1; i <= 20; i++) {
+		fixed_rate = c.tick_hz * i / 20.0;
+		Result ri = run(c, 0, 0.5, constant);
+		Result rp = run(c, 1, 0.5, constant);
+		Result ra = run(c, 2, 0.5, constant);
+		printf("%11.0f   %9.2f%%  %8.2f%%  %8.2f%%   %d\n", fixed_rate,
+			ri.load * 100, rp.load * 100, ra.load * 100,
+			(int)(ra.edges - ra.position));
+		if (!crossover && ri.load > rp.load) crossover = fixed_rate;
+	}
+	printf("\ncalculated crossover: %.0f edges/sec, measured: between %.0f and %.0f\n",
+		cross, crossover - c.tick_hz / 20.0, crossover);
+	printf("adaptive thresholds: polling above %u, interrupts below %u\n", c.high, c.low);
+
+	// ramp up past the polling limit and back down again
+	peak = c.tick_hz * 0.95;
+	Result r = run(c, 2, 2.0, ramp);
+	printf("ramp to %.0f edges/sec: %u edges, position %d, %u mode switches, load %.2f%%\n",
+		peak, r.edges, (int)r.position, r.switches, r.load * 100);
+	return (r.position == (int32_t)r.edges) ? 0 : 1;
+}
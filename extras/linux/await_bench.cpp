@@ -0,0 +1,180 @@
+/* Encoder Library - EncoderAwait wake-up latency against polling
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// An event thread feeds edges the way EncoderGpioEvents::process() does,
+// one every interval microseconds, stamping the time of each.  A waiter
+// thread finds out about each count in one of 4 ways:
+//
+//   await     a coroutine in co_await nextEdge(), on EncoderAwaitLoop
+//   poll 1ms  read() in a loop, sleeping 1 ms between reads
+//   poll 50us the same, sleeping 50 us
+//   spin      read() in a loop without sleeping
+//
+// and the time from edge to noticing it is measured, with the CPU time
+// the waiter thread used.  Awaiting should be near the best latency at
+// near zero CPU.  First, waitUntilPosition() and waitForMotion() are
+// checked, including a timeout and a write() past the target.
+//
+//   g++ -std=c++20 -O2 -I../.. await_bench.cpp -o await_bench -lpthread
+//   ./await_bench [interval_us]
+
+#include <EncoderLinuxGpio.h>
+#include <EncoderAwait.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+struct NotifyTraits : EncoderDefaultTraits {
+	static const bool notify = true;
+};
+typedef BasicEncoder<NotifyTraits> NotifyEncoder;
+
+static NotifyEncoder enc;
+static EncoderAwaitLoop executor;
+static BasicEncoderAwait<NotifyEncoder, EncoderAwaitLoop> waits(enc, executor);
+
+static const int EDGES = 2000;
+static uint64_t stamp[EDGES + 1];	// when each count's edge was fed
+static uint64_t seen[EDGES + 1];	// when the waiter noticed it
+static std::atomic<int> fed(0);
+
+static uint64_t now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t thread_cpu_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// 1 forward count, fed like process() does
+static void edge() {
+	static const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+	static int i = 0;
+	volatile uint8_t *levels = encoder_linux_levels();
+	noInterrupts();
+	uint8_t line = (i & 1) ? 0 : 1;
+	levels[0] = seq[i & 3][0];
+	levels[1] = seq[i & 3][1];
+	i++;
+	stamp[fed + 1] = now_ns();
+	fed++;
+	(*encoder_linux_vectors()[line])(line);
+	interrupts();
+}
+
+static void feeder(uint32_t interval_us, int count) {
+	for (int n=0; n < count; n++) {
+		delayMicroseconds(interval_us);
+		edge();
+	}
+}
+
+static EncoderTask checks(bool &ok) {
+	int32_t start = enc.read();
+	std::thread t(feeder, 100, 30);
+	int32_t p = co_await waits.waitUntilPosition(start + 10);
+	ok &= (p == start + 10);
+	bool moved = co_await waits.waitForMotion(5, 1000000);
+	ok &= moved && enc.read() >= p + 5;
+	t.join();
+	uint64_t before = now_ns();
+	moved = co_await waits.waitForMotion(5, 20000);	// nothing moves
+	uint64_t waited = (now_ns() - before) / 1000;
+	ok &= !moved && waited >= 20000 && waited < 40000;
+	// a write past the target resumes the waiter, with the written position
+	int32_t jump = enc.read() + 1000;
+	std::thread w([jump]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		enc.write(jump);
+	});
+	int32_t q = co_await waits.waitUntilPosition(jump - 500);
+	w.join();
+	ok &= (q == jump);
+	printf("waitUntilPosition %d, waitForMotion ok, timeout after %u us, write %s  %s\n",
+		p - start, (unsigned)waited, q == jump ? "ok" : "missed", ok ? "ok" : "FAIL");
+	executor.stop();
+}
+
+static uint64_t await_cpu;
+static EncoderTask awaiter(int32_t base) {
+	uint64_t cpu = thread_cpu_ns();
+	for (int n=1; n <= EDGES; n++) {
+		int32_t p = co_await waits.nextEdge();
+		seen[p - base] = now_ns();
+	}
+	await_cpu = thread_cpu_ns() - cpu;
+	executor.stop();
+}
+
+// poll with sleeps of sleep_us, or spin when 0
+static uint64_t poller(int32_t base, uint32_t sleep_us) {
+	uint64_t cpu = thread_cpu_ns();
+	int32_t last = base;
+	while (last - base < EDGES) {
+		int32_t p = enc.read();
+		if (p != last) {
+			uint64_t t = now_ns();
+			for (int32_t i = last + 1; i <= p; i++) seen[i - base] = t;
+			last = p;
+		} else if (sleep_us) {
+			delayMicroseconds(sleep_us);
+		}
+	}
+	return thread_cpu_ns() - cpu;
+}
+
+static void report(const char *name, uint64_t cpu_ns, uint64_t wall_ns) {
+	std::vector<double> lat;
+	for (int n=1; n <= EDGES; n++) lat.push_back((seen[n] - stamp[n]) / 1000.0);
+	std::sort(lat.begin(), lat.end());
+	double sum = 0;
+	for (size_t i=0; i < lat.size(); i++) sum += lat[i];
+	printf("  %-10s %8.1f %8.1f %8.1f     %5.1f%%\n", name, sum / lat.size(),
+		lat[lat.size() * 99 / 100], lat.back(), 100.0 * cpu_ns / wall_ns);
+}
+
+int main(int argc, char **argv) {
+	uint32_t interval = (argc > 1) ? atoi(argv[1]) : 500;
+	enc.begin(0, 1);
+	waits.begin();
+
+	bool ok = true;
+	checks(ok);
+	executor.run();
+
+	printf("\nwake-up latency, 1 count every %u us\n", interval);
+	printf("  waiter     avg us   p99 us   max us   waiter CPU\n");
+	fed = 0;
+	int32_t base = enc.read();
+	uint64_t begin = now_ns();
+	awaiter(base);
+	std::thread t(feeder, interval, EDGES);
+	executor.run();
+	t.join();
+	report("await", await_cpu, now_ns() - begin);
+
+	const uint32_t sleeps[] = {1000, 50, 0};
+	const char *names[] = {"poll 1ms", "poll 50us", "spin"};
+	for (int i=0; i < 3; i++) {
+		fed = 0;
+		base = enc.read();
+		uint64_t cpu = 0;
+		begin = now_ns();
+		std::thread w([&] { cpu = poller(base, sleeps[i]); });
+		feeder(interval, EDGES);
+		w.join();
+		report(names[i], cpu, now_ns() - begin);
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/* Encoder Library - build an EncoderCalibration table from a trace
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Reads a reference trace, 1 sample per line:
+//
+//   <encoder count> <reference position, in counts>
+//
+// for example from a laser interferometer or a better encoder on the
+// same axis, moved slowly over the whole range.  The error (reference
+// minus count) is averaged at each position, then covered with as few
+// straight segments as keep every averaged point within the tolerance.
+// The table is printed as C source for EncoderCalibration, and then
+// checked by running every sample of the trace through it, in order,
+// which also shows how often the segment had to be looked up.
+//
+//   g++ -O2 -I../.. calibrate.cpp -o calibrate
+//   ./calibrate [-p period] [-t tolerance] trace.txt > table.h
+//   ./calibrate -demo                 # a made up eccentric disk
+//
+// -p is counts per revolution for a rotary axis, where the error
+// repeats every turn.  -t is the allowed error of the fit in counts,
+// 0.25 by default.
+
+#include <EncoderLinuxGpio.h>
+#include <EncoderCalibration.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <map>
+
+struct Sample {
+	int32_t count;
+	double reference;
+};
+
+struct Point {
+	int32_t x;
+	double error;
+};
+
+static int32_t wrap(int32_t count, uint32_t period) {
+	if (!period) return count;
+	int32_t r = count % (int32_t)period;
+	return (r < 0) ? r + period : r;
+}
+
+// average error at each position
+static std::vector<Point> average(const std::vector<Sample> &trace, uint32_t period) {
+	std::map<int32_t, std::pair<double, int> > sum;
+	for (size_t i=0; i < trace.size(); i++) {
+		std::pair<double, int> &s = sum[wrap(trace[i].count, period)];
+		s.first += trace[i].reference - trace[i].count;
+		s.second++;
+	}
+	std::vector<Point> points;
+	for (std::map<int32_t, std::pair<double, int> >::iterator it = sum.begin();
+	  it != sum.end(); ++it) {
+		Point p = {it->first, it->second.first / it->second.second};
+		points.push_back(p);
+	}
+	return points;
+}
+
+// Greedy fit: from each knot, reach as far as a straight line to a later
+// point keeps all points between within the tolerance.  Each point
+// between allows a range of slopes from the knot, so the line to point j
+// fits if its slope is within all their ranges.  Keeping the narrowing
+// range makes each knot O(n), instead of testing every point again for
+// every candidate.
+static std::vector<size_t> fit(const std::vector<Point> &p, double tolerance) {
+	std::vector<size_t> knots;
+	size_t k = 0;
+	knots.push_back(0);
+	while (k + 1 < p.size()) {
+		size_t best = k + 1;
+		double lowest = -HUGE_VAL, highest = HUGE_VAL;
+		for (size_t j = k + 1; j < p.size(); j++) {
+			double dx = p[j].x - p[k].x;
+			double slope = (p[j].error - p[k].error) / dx;
+			if (slope < lowest || slope > highest) break;
+			best = j;
+			// slopes keeping point j within the tolerance
+			double lo = (p[j].error - tolerance - p[k].error) / dx;
+			double hi = (p[j].error + tolerance - p[k].error) / dx;
+			if (lo > lowest) lowest = lo;
+			if (hi < highest) highest = hi;
+		}
+		knots.push_back(best);
+		k = best;
+	}
+	return knots;
+}
+
+struct Residual {
+	double max, rms;
+};
+
+static Residual residual(const std::vector<Sample> &trace, bool corrected,
+  EncoderCalibration *cal) {
+	Residual r = {0, 0};
+	for (size_t i=0; i < trace.size(); i++) {
+		int32_t c = corrected ? cal->correct(trace[i].count) : trace[i].count;
+		double e = trace[i].reference - c;
+		if (fabs(e) > r.max) r.max = fabs(e);
+		r.rms += e * e;
+	}
+	r.rms = trace.empty() ? 0 : sqrt(r.rms / trace.size());
+	return r;
+}
+
+// back and forth over 5 turns of a 4096 count disk, mounted off center
+static std::vector<Sample> demo() {
+	std::vector<Sample> trace;
+	const double pi = 3.14159265358979;
+	int32_t count = 0;
+	uint32_t seed = 1;
+	for (int pass = 0; pass < 4; pass++) {
+		int dir = (pass & 1) ? -1 : 1;
+		for (int i=0; i < 5 * 4096; i++) {
+			count += dir;
+			double a = 2 * pi * wrap(count, 4096) / 4096;
+			double error = 3.5 * sin(a) + 1.2 * sin(2 * a + 0.5);
+			seed = seed * 1103515245 + 12345;
+			double noise = ((seed >> 16) & 0xFF) / 2560.0 - 0.05;
+			Sample s = {count, count + error + noise};
+			trace.push_back(s);
+		}
+	}
+	return trace;
+}
+
+int main(int argc, char **argv) {
+	uint32_t period = 0;
+	double tolerance = 0.25;
+	const char *file = 0;
+	bool is_demo = false;
+	for (int i=1; i < argc; i++) {
+		if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+			period = strtoul(argv[++i], 0, 0);
+		} else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+			tolerance = atof(argv[++i]);
+		} else if (!strcmp(argv[i], "-demo")) {
+			is_demo = true;
+			period = 4096;
+		} else {
+			file = argv[i];
+		}
+	}
+	std::vector<Sample> trace;
+	if (is_demo) {
+		trace = demo();
+	} else {
+		FILE *f = file ? fopen(file, "r") : stdin;
+		if (!f) {
+			perror(file);
+			return 1;
+		}
+		Sample s;
+		long c;
+		while (fscanf(f, "%ld %lf", &c, &s.reference) == 2) {
+			s.count = (int32_t)c;
+			trace.push_back(s);
+		}
+		if (f != stdin) fclose(f);
+	}
+	std::vector<Point> points = average(trace, period);
+	if (points.size() < 2) {
+		fprintf(stderr, "need at least 2 positions in the trace\n");
+		return 1;
+	}
+	std::vector<size_t> knots = fit(points, tolerance);
+
+	std::vector<EncoderCalibrationPoint> table;
+	printf("// %u points from %u samples, tolerance %.3f counts",
+		(unsigned)knots.size(), (unsigned)trace.size(), tolerance);
+	if (period) printf(", period %u", period);
+	printf("\nconst EncoderCalibrationPoint calibration[] = {\n");
+	for (size_t i=0; i < knots.size(); i++) {
+		const Point &p = points[knots[i]];
+		long c = lround(p.error * ENCODER_CALIBRATION_SCALE);
+		if (c > 32767 || c < -32768) {
+			fprintf(stderr, "correction at %d is too large\n", p.x);
+			return 1;
+		}
+		EncoderCalibrationPoint t = {p.x, (int16_t)c};
+		table.push_back(t);
+		printf("\t{%d, %ld},\n", p.x, c);
+	}
+	printf("};\n");
+
+	Encoder unused;
+	EncoderCalibration cal(unused, &table[0], table.size(), period);
+	Residual before = residual(trace, false, &cal);
+	Residual after = residual(trace, true, &cal);
+	fprintf(stderr, "error before: max %.2f rms %.2f counts, after: max %.2f rms %.2f "
+		"counts (rounded to whole counts)\n", before.max, before.rms, after.max, after.rms);
+	fprintf(stderr, "%u segment loads for %u reads\n", cal.seeks, (unsigned)trace.size());
+	return 0;
+}
@@ -0,0 +1,149 @@
+/* Encoder Library - position compare against a reference
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Drives 2 encoders with compare targets through a random walk, with
+// write() and readAndReset() mixed in, one using interrupts and one
+// polled with a 16 bit count.  A reference keeps its own position and
+// fires a target going up when a count reaches it and going down when a
+// count leaves it below, never for a written position.  Every callback
+// must match the reference, in order.
+//
+//   g++ -O2 -I../.. compare_check.cpp -o compare_check
+//   ./compare_check
+
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <stdio.h>
+
+struct CompareTraits : EncoderDefaultTraits {
+	static const bool compare = true;
+};
+
+struct PolledCompareTraits : EncoderPolledTraits {
+	static const bool compare = true;
+	typedef int16_t count_t;
+};
+
+static const int32_t targets[] = {-300, -40, -5, 0, 3, 4, 10, 11, 250, 1000};
+static const int16_t targets16[] = {-300, -40, -5, 0, 3, 4, 10, 11, 250, 1000};
+static const int ntargets = sizeof(targets) / sizeof(targets[0]);
+
+struct Log {
+	int32_t target[64];
+	int8_t direction[64];
+	int n;
+};
+static Log got, got16;
+
+static void hit(int32_t target, int8_t direction) {
+	if (got.n < 64) {
+		got.target[got.n] = target;
+		got.direction[got.n++] = direction;
+	}
+}
+static void hit16(int16_t target, int8_t direction) {
+	if (got16.n < 64) {
+		got16.target[got16.n] = target;
+		got16.direction[got16.n++] = direction;
+	}
+}
+
+static uint32_t rng = 4321;
+static uint32_t random32() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static int errors = 0;
+
+static bool same(const Log &a, const Log &b) {
+	if (a.n != b.n) return false;
+	for (int i=0; i < a.n; i++) {
+		if (a.target[i] != b.target[i] || a.direction[i] != b.direction[i]) return false;
+	}
+	return true;
+}
+
+static void report(const char *what, uint32_t step, const Log &want, const Log &have) {
+	if (errors++ >= 5) return;
+	printf("error: %s at step %u, want", what, step);
+	for (int i=0; i < want.n; i++) printf(" %+d", want.target[i] * want.direction[i]);
+	printf(", got");
+	for (int i=0; i < have.n; i++) printf(" %+d", have.target[i] * have.direction[i]);
+	printf("\n");
+}
+
+int main() {
+	static const uint8_t seq[4][2] = {{0,0}, {0,1}, {1,1}, {1,0}};
+	volatile uint8_t *levels = encoder_linux_levels();
+	BasicEncoder<CompareTraits> enc;
+	BasicEncoder<PolledCompareTraits> enc16;
+	enc.begin(0, 1);
+	enc16.begin(0, 1);	// polled, reads the same lines
+	enc.setCompareTargets(targets, ntargets);
+	enc.onCompare(hit);
+	enc16.setCompareTargets(targets16, ntargets);
+	enc16.onCompare(hit16);
+
+	int32_t position = 0;
+	uint8_t phase = 0;
+	uint32_t writes = 0, resets = 0, fired = 0;
+	for (uint32_t step=0; step < 2000000; step++) {
+		Log want;
+		want.n = 0;
+		got.n = 0;
+		got16.n = 0;
+		uint32_t r = random32();
+		if ((r & 0x3FF) == 0) {
+			// jump somewhere near the targets, or past them all
+			int32_t p = (int32_t)(random32() % 1400) - 400;
+			enc.write(p);
+			enc16.write(p);
+			position = p;
+			writes++;
+		} else if ((r & 0x3FF) == 1) {
+			enc.readAndReset();
+			enc16.readAndReset();
+			position = 0;
+			resets++;
+		} else {
+			// drift upward a little more often than down, so the walk
+			// reaches the far targets
+			int8_t dir = ((r >> 10) % 9 < 5) ? 1 : -1;
+			if (position > 1100) dir = -1;
+			if (position < -400) dir = 1;
+			phase = (phase + dir) & 3;
+			int32_t before = position;
+			position += dir;
+			for (int i=0; i < ntargets; i++) {
+				if (dir > 0 && before < targets[i] && position >= targets[i]) {
+					want.target[want.n] = targets[i];
+					want.direction[want.n++] = 1;
+				}
+				if (dir < 0 && before >= targets[i] && position < targets[i]) {
+					want.target[want.n] = targets[i];
+					want.direction[want.n++] = -1;
+				}
+			}
+			uint8_t line = (seq[phase][0] != levels[0]) ? 0 : 1;
+			levels[0] = seq[phase][0];
+			levels[1] = seq[phase][1];
+			(*encoder_linux_vectors()[line])(line);
+			enc16.read();
+		}
+		fired += want.n;
+		if (enc.read() != position || enc16.read() != (int16_t)position) {
+			if (errors++ < 5) printf("error: position %d, expected %d\n", enc.read(), position);
+		}
+		if (!same(want, got)) report("interrupt", step, want, got);
+		if (!same(want, got16)) report("polled", step, want, got16);
+	}
+	printf("%u writes, %u readAndReset, %u targets fired: %s\n",
+		writes, resets, fired, errors ? "FAIL" : "ok");
+	return errors ? 1 : 0;
+}
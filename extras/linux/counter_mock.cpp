@@ -0,0 +1,193 @@
+/* Encoder Library - EncoderCounter against register level models
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Runs EncoderCounter's counter classes on the host with models of the
+// ESP32 PCNT and i.MX RT ENC registers in place of the real Hal.  The
+// models count edges the way the reference manuals describe, using
+// whatever the driver wrote to the configuration registers and
+// whichever pins it routed, so wrong bits or routing show up as wrong
+// counts.  Random motion, including bursts near the 16 bit limit, must
+// give the same position as Encoder's own truth table.
+//
+//   g++ -O2 -I../.. counter_mock.cpp -o counter_mock
+//   ./counter_mock
+
+#include <EncoderCounter.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int errors = 0;
+static void fail(const char *what, long a, long b) {
+	if (errors++ < 10) printf("error: %s (%ld, expected %ld)\n", what, a, b);
+}
+
+static uint8_t level[64];
+
+// ESP32 PCNT: 8 units, 2 channels each
+struct MockPcnt {
+	uint32_t reg[0xC0 / 4];
+	int route[128];		// GPIO matrix: signal -> pin
+	bool clock;
+	MockPcnt() : clock(false) {
+		for (int i=0; i < 0xC0 / 4; i++) reg[i] = 0;
+		for (int i=0; i < 128; i++) route[i] = -1;
+	}
+	static int signal(int u, int which) { return ((u < 5) ? 39 + u * 4 : 71 + (u - 5) * 4) + which; }
+	void edge(int pin) {
+		for (int u=0; u < 8; u++) {
+			uint32_t ctrl = reg[ENCODER_PCNT_CTRL / 4] >> (u * 2);
+			if (ctrl & 3) continue;		// reset or paused
+			uint32_t conf0 = reg[ENCODER_PCNT_CONF0(u) / 4];
+			for (int ch=0; ch < 2; ch++) {
+				if (route[signal(u, ch)] != pin) continue;
+				int c = route[signal(u, ch + 2)];
+				uint32_t f = conf0 >> (16 + ch * 8);
+				uint32_t action = level[pin] ? (f >> 2) & 3 : f & 3;
+				uint32_t control = (c >= 0 && level[c]) ? (f >> 4) & 3 : (f >> 6) & 3;
+				int d = (action == 1) ? 1 : (action == 2) ? -1 : 0;
+				if (control == 1) d = -d;
+				else if (control == 2) d = 0;
+				count(u, d);
+			}
+		}
+	}
+	void count(int u, int d) {
+		int16_t cnt = (int16_t)reg[ENCODER_PCNT_CNT(u) / 4] + d;
+		uint32_t conf2 = reg[ENCODER_PCNT_CONF2(u) / 4];
+		if (cnt == (int16_t)(conf2 & 0xFFFF) || cnt == (int16_t)(conf2 >> 16)) cnt = 0;
+		reg[ENCODER_PCNT_CNT(u) / 4] = (uint16_t)cnt;
+	}
+	void write(uint32_t offset, uint32_t value) {
+		if (!clock) fail("PCNT register written before clock enable", offset, 0);
+		reg[offset / 4] = value;
+		if (offset == ENCODER_PCNT_CTRL) {
+			for (int u=0; u < 8; u++) {
+				if (value & (1u << (u * 2))) reg[ENCODER_PCNT_CNT(u) / 4] = 0;
+			}
+		}
+	}
+} pcnt;
+
+struct MockPcntHal {
+	static uint32_t read(uint32_t offset) { return pcnt.reg[offset / 4]; }
+	static void write(uint32_t offset, uint32_t value) { pcnt.write(offset, value); }
+	static void enable() { pcnt.clock = true; }
+	static void input(uint8_t pin) { }
+	static void route(uint8_t pin, uint8_t signal) { pcnt.route[signal] = pin; }
+};
+
+// i.MX RT ENC: 4 modules, phases from XBAR1 outputs
+struct MockEnc {
+	uint16_t reg[5][0x28 / 2];
+	uint32_t position[5];
+	int route[128];		// XBAR1 output -> pin
+	uint8_t phase[5];	// last A, B
+	MockEnc() {
+		for (int n=0; n < 5; n++) {
+			for (int i=0; i < 0x28 / 2; i++) reg[n][i] = 0;
+			position[n] = 0;
+			phase[n] = 0;
+		}
+		for (int i=0; i < 128; i++) route[i] = -1;
+	}
+	void edge(int pin) {
+		for (int n=1; n <= 4; n++) {
+			int a = route[66 + (n - 1) * 5], b = route[67 + (n - 1) * 5];
+			if (pin != a && pin != b) continue;
+			uint8_t now = (a >= 0 ? level[a] : 0) | ((b >= 0 ? level[b] : 0) << 1);
+			// phase A leading phase B counts up: A B = 00 10 11 01
+			static const int8_t step[4][4] = {
+				{0, 1, -1, 0}, {-1, 0, 0, 1}, {1, 0, 0, -1}, {0, -1, 1, 0}
+			};
+			int d = step[phase[n]][now];
+			phase[n] = now;
+			if (reg[n][ENCODER_ENC_CTRL / 2] & ENCODER_ENC_CTRL_REV) d = -d;
+			position[n] += d;
+		}
+	}
+	uint16_t read(int n, uint32_t offset) {
+		if (offset == ENCODER_ENC_UPOS) {
+			reg[n][ENCODER_ENC_LPOSH / 2] = position[n] & 0xFFFF;
+			return position[n] >> 16;
+		}
+		if (offset == ENCODER_ENC_LPOSH) return reg[n][offset / 2];
+		fail("unexpected ENC read", offset, 0);
+		return 0;
+	}
+	void write(int n, uint32_t offset, uint16_t value) {
+		if (offset == ENCODER_ENC_CTRL && (value & ENCODER_ENC_CTRL_SWIP)) {
+			position[n] = ((uint32_t)reg[n][ENCODER_ENC_UINIT / 2] << 16)
+				| reg[n][ENCODER_ENC_LINIT / 2];
+			value &= ~ENCODER_ENC_CTRL_SWIP;	// self clearing
+		}
+		reg[n][offset / 2] = value;
+	}
+} enc;
+
+struct MockEncHal {
+	static uint16_t read16(uint8_t n, uint32_t offset) { return enc.read(n, offset); }
+	static void write16(uint8_t n, uint32_t offset, uint16_t value) { enc.write(n, offset, value); }
+	static void enable(uint8_t n) { }
+	static bool route(uint8_t pin, uint8_t output) {
+		if (pin == 6 || pin > 8) return false;	// no XBAR input
+		enc.route[output] = pin;
+		return true;
+	}
+};
+
+static void set(int pin, int value) {
+	if (level[pin] == value) return;
+	level[pin] = value;
+	pcnt.edge(pin);
+	enc.edge(pin);
+}
+
+// 1 step of Encoder's forward direction, pin2 leading: A B = 00 01 11 10
+static void step(int pinA, int pinB, int dir, uint32_t &phase) {
+	static const uint8_t seq[4][2] = {{0,0}, {0,1}, {1,1}, {1,0}};
+	phase = (phase + dir) & 3;
+	set(pinA, seq[phase][0]);
+	set(pinB, seq[phase][1]);
+}
+
+template <class Counter>
+static void check(const char *name, BasicEncoderCounter<Counter> &e, int pinA, int pinB) {
+	int errors_before = errors;
+	uint32_t phase = 0;
+	int32_t expect = 0;
+	srand(2);
+	for (int i=0; i < 20000; i++) {
+		// mostly small moves, sometimes bursts near half the 16 bit limit
+		int n = (rand() % 10 == 0) ? rand() % 32000 - 16000 : rand() % 200 - 100;
+		int dir = (n < 0) ? -1 : 1;
+		for (int k=0; k != n; k += dir) step(pinA, pinB, dir, phase);
+		expect += n;
+		if (e.read() != expect) fail(name, e.read(), expect);
+		if (i == 10000) {
+			e.write(-5);
+			expect = -5;
+			if (e.readAndReset() != -5) fail("readAndReset", e.read(), -5);
+			expect = 0;
+		}
+	}
+	printf("%s: position %ld, %s\n", name, (long)e.read(),
+		errors == errors_before ? "ok" : "FAILED");
+}
+
+int main() {
+	BasicEncoderCounter<EncoderPcnt<MockPcntHal> > pcnt3(3), pcnt6(6);
+	if (!pcnt3.begin(12, 13) || !pcnt6.begin(20, 21)) fail("PCNT begin", 0, 1);
+	check("ESP32 PCNT unit 3", pcnt3, 12, 13);
+	check("ESP32 PCNT unit 6", pcnt6, 20, 21);
+
+	BasicEncoderCounter<EncoderImxEnc<MockEncHal> > enc2(2), bad(3);
+	if (!enc2.begin(7, 8)) fail("ENC begin", 0, 1);
+	if (bad.begin(6, 9)) fail("ENC begin with pins lacking XBAR", 1, 0);
+	check("i.MX RT ENC2", enc2, 7, 8);
+
+	printf("%s, %d errors\n", errors ? "FAILED" : "ok", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/* Encoder Library - EncoderCursor deltas against write() and wrapping
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Turns a simulated 16 bit Encoder back and forth with 3 cursors
+// following it, read at different rates, while the position is
+// written and readAndReset() now and then, like homing.  Each cursor's
+// deltas must add up to exactly the counts turned, including after
+// the movement counter wraps around many times.
+//
+//   g++ -O2 -I../.. cursor_check.cpp -o cursor_check
+//   ./cursor_check
+
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <EncoderCursor.h>
+#include <stdio.h>
+
+struct SmallTraits : EncoderPolledTraits {
+	typedef int16_t count_t;
+	static const bool movement = true;
+};
+typedef BasicEncoder<SmallTraits> SmallEncoder;
+
+static uint32_t rng = 13579;
+static uint32_t random32() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+int main() {
+	volatile uint8_t *levels = encoder_linux_levels();
+	levels[0] = 0;
+	levels[1] = 0;
+	SmallEncoder enc;
+	enc.begin(0, 1);
+	BasicEncoderCursor<SmallEncoder> cursor[3] = {enc, enc, enc};
+	const uint32_t every[3] = {1, 97, 20000};	// steps between deltas
+	long sum[3] = {0, 0, 0};
+	long turned = 0;
+	uint8_t phase = 0;
+	int errors = 0;
+
+	static const uint8_t gray[4] = {0, 1, 3, 2};
+	for (uint32_t step=1; step <= 1000000; step++) {
+		// mostly one way, so the counter wraps
+		int8_t dir = (random32() % 8 == 0) ? -1 : 1;
+		phase = (phase + dir) & 3;
+		levels[0] = gray[phase] & 1;
+		levels[1] = gray[phase] >> 1;
+		enc.read();
+		turned -= dir;		// Encoder counts this sequence down
+		uint32_t r = random32();
+		if (r % 5000 == 0) enc.write((int16_t)(r >> 16));
+		if (r % 7000 == 1) enc.readAndReset();
+		for (int c=0; c < 3; c++) {
+			if (step % every[c] == 0) sum[c] += cursor[c].delta();
+		}
+	}
+	for (int c=0; c < 3; c++) {
+		sum[c] += cursor[c].peek();
+		if (sum[c] != turned) {
+			printf("error: cursor every %u steps, %ld, turned %ld\n", every[c], sum[c], turned);
+			errors++;
+		}
+	}
+	// write() alone is no movement
+	cursor[0].sync();
+	enc.write(1234);
+	if (cursor[0].delta() != 0) {
+		printf("error: write() seen as movement\n");
+		errors++;
+	}
+	printf("3 cursors, %ld counts turned: %s\n", turned, errors ? "FAIL" : "ok");
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+/* Encoder Library - Linux edge event benchmark
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Feeds synthetic quadrature edges through a pipe, standing in for the
+// GPIO character device, and measures how many events/sec
+// EncoderGpioEvents and Encoder can decode.  No GPIO hardware needed.
+//
+//   g++ -O2 -I../.. event_bench.cpp -o event_bench -lpthread
+//   ./event_bench [events]
+
+#include <EncoderLinuxGpio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+#define LINE_A 17
+#define LINE_B 27
+
+static void writer(int fd, uint32_t total) {
+	// levels of A and B, 1 step forward per edge
+	static const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+	struct gpio_v2_line_event buf[256];
+	uint32_t n = 0;
+	uint64_t ns = 1000000;
+	while (n < total) {
+		int count = 0;
+		while (count < 256 && n < total) {
+			struct gpio_v2_line_event &ev = buf[count++];
+			memset(&ev, 0, sizeof(ev));
+			const uint8_t *now = seq[n & 3];
+			const uint8_t *prev = seq[(n - 1) & 3];
+			ev.offset = (now[0] != prev[0]) ? LINE_A : LINE_B;
+			uint8_t level = (ev.offset == LINE_A) ? now[0] : now[1];
+			ev.id = level ? GPIO_V2_LINE_EVENT_RISING_EDGE : GPIO_V2_LINE_EVENT_FALLING_EDGE;
+			ev.timestamp_ns = ns += 2000;
+			ev.seqno = ++n;
+			ev.line_seqno = n;
+		}
+		const uint8_t *p = (const uint8_t *)buf;
+		size_t len = count * sizeof(buf[0]);
+		while (len) {
+			ssize_t r = write(fd, p, len);
+			if (r <= 0) return;
+			p += r;
+			len -= r;
+		}
+	}
+	close(fd);
+}
+
+int main(int argc, char **argv) {
+	uint32_t total = (argc > 1) ? strtoul(argv[1], NULL, 0) : 10000000;
+	int fds[2];
+	if (pipe(fds) < 0) {
+		perror("pipe");
+		return 1;
+	}
+	EncoderGpioEvents gpio;
+	gpio.begin(fds[0]);
+	gpio.setLevel(LINE_A, 0);
+	gpio.setLevel(LINE_B, 0);
+	Encoder enc(LINE_A, LINE_B);
+
+	struct timespec t0, t1;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	std::thread t(writer, fds[1], total);
+	while (gpio.process() > 0) ;
+	t.join();
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	double sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+	printf("events:           %u\n", gpio.events);
+	printf("read() calls:     %u (%.1f events each)\n", gpio.batches,
+		(double)gpio.events / gpio.batches);
+	printf("lost:             %u\n", gpio.lost);
+	printf("position:         %d (expected %u)\n", (int)enc.read(), total);
+	printf("events/sec:       %.0f\n", gpio.events / sec);
+	return (enc.read() == (int32_t)total) ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+/* Encoder Library - signal generator characterization
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Drives Encoder on the host with EncoderSignalGenerator, to find the
+// highest speed it can track and to compare how the filter settings
+// handle bounce, missed edges, phase error and jitter.  Every run is
+// reproducible from its seed.
+//
+// The interrupt is modeled with a latency, from the edge until the pins
+// are read, and a service time, during which further edges only make
+// the interrupt pending again.  When 2 edges land within one latency,
+// update() sees both at once, as on real hardware.
+//
+// Part 1 also sends a signal through a pipe as gpio_v2_line_event
+// records, to check EncoderGpioEvents with the same signals.
+//
+//   g++ -O2 -I../.. generator_bench.cpp -o generator_bench
+//   ./generator_bench [latency_ns] [service_ns]
+
+#include <EncoderLinuxGpio.h>
+#include <EncoderGenerator.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LINE_A 2
+#define LINE_B 3
+
+struct Rejecting : EncoderDefaultTraits {
+	static const uint8_t filter = ENCODER_FILTER_REJECT;
+};
+
+static uint32_t latency = 1000, service = 500;
+
+// run a generator into an already started encoder, return its count
+template <class EncoderType>
+static int32_t run(EncoderSignalGenerator &gen, EncoderType &enc) {
+	volatile uint8_t *levels = encoder_linux_levels();
+	EncoderSignalEdge e;
+	bool more = gen.next(e);
+	while (more) {
+		// first edge starts an interrupt, which reads the pins at
+		// the end of the latency, after any other edges by then
+		uint64_t when = e.ns + latency;
+		uint8_t line = 0;
+		while (more && e.ns <= when) {
+			line = e.pin ? LINE_B : LINE_A;
+			levels[line] = e.level;
+			more = gen.next(e);
+		}
+		encoder_linux_isr_t isr = encoder_linux_vectors()[line];
+		if (isr) (*isr)(line);
+		// edges during the service time are handled by 1 more run
+		// of the interrupt, right after
+		uint64_t busy = when + service;
+		while (more && e.ns <= busy) {
+			line = e.pin ? LINE_B : LINE_A;
+			levels[line] = e.level;
+			more = gen.next(e);
+			if (!more || e.ns > busy) {
+				isr = encoder_linux_vectors()[line];
+				if (isr) (*isr)(line);
+			}
+		}
+	}
+	return enc.read();
+}
+
+template <class EncoderType>
+static int32_t measure(EncoderSignalGenerator &gen) {
+	encoder_linux_levels()[LINE_A] = 0;
+	encoder_linux_levels()[LINE_B] = 0;
+	EncoderType enc;
+	enc.begin(LINE_A, LINE_B);
+	return run(gen, enc);
+}
+
+static void scenario(const char *name, EncoderSignalGenerator &gen) {
+	gen.seed(1234);
+	int32_t none = measure<Encoder>(gen);
+	int32_t truth = gen.position();
+	gen.seed(1234);
+	int32_t reject = measure<BasicEncoder<Rejecting> >(gen);
+	printf("%-28s true %7d  FILTER_NONE %7d  FILTER_REJECT %7d\n",
+		name, (int)truth, (int)none, (int)reject);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1) latency = atoi(argv[1]);
+	if (argc > 2) service = atoi(argv[2]);
+	EncoderSignalGenerator gen;
+
+	// 1: the same signal through the events backend
+	int fds[2];
+	if (pipe(fds) < 0) return 1;
+	gen.setSweep(1000, 50000, 200000);
+	gen.setJitter(2000);
+	gen.setBounce(0.05, 2, 5000);
+	gen.seed(1);
+	EncoderGpioEvents gpio;
+	gpio.begin(fds[0]);
+	gpio.setLevel(LINE_A, 0);
+	gpio.setLevel(LINE_B, 0);
+	Encoder piped(LINE_A, LINE_B);
+	EncoderSignalEdge e;
+	uint32_t n = 0;
+	while (gen.next(e)) {
+		struct gpio_v2_line_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.timestamp_ns = e.ns;
+		ev.offset = e.pin ? LINE_B : LINE_A;
+		ev.id = e.level ? GPIO_V2_LINE_EVENT_RISING_EDGE : GPIO_V2_LINE_EVENT_FALLING_EDGE;
+		ev.seqno = ++n;
+		if (write(fds[1], &ev, sizeof(ev)) != sizeof(ev)) return 1;
+		if (n % 64 == 0) gpio.process();
+	}
+	close(fds[1]);
+	while (gpio.process() > 0) ;
+	printf("events backend: %u edges, true %d, counted %d\n\n",
+		gpio.events, (int)gen.position(), (int)piped.read());
+
+	// 2: filter behavior, at a speed the interrupt easily keeps up with
+	printf("latency %u ns, service %u ns\n", latency, service);
+	gen.setJitter(0);
+	gen.setBounce(0, 0, 0);
+	gen.setSweep(20000, 20000, 100000);
+	scenario("clean 20k counts/sec", gen);
+	gen.setPhaseError(0.6);
+	scenario("phase error 0.6", gen);
+	gen.setPhaseError(0);
+	gen.setJitter(10000);
+	scenario("jitter 10 us", gen);
+	gen.setJitter(0);
+	gen.setBounce(0.2, 3, 3000);
+	scenario("bounce 20%, 3x in 3 us", gen);
+	gen.setBounce(0, 0, 0);
+	gen.setMissRate(0.01);
+	scenario("missed edges 1%", gen);
+	gen.setMissRate(0);
+	gen.setSweep(-20000, -20000, 100000);
+	gen.setMissRate(0.01);
+	scenario("missed edges 1%, reverse", gen);
+	gen.setMissRate(0);
+
+	// 3: highest speed tracked without error, in 2% steps
+	float last_ok = 0;
+	for (float rate = 10000; rate < 10000000; rate *= 1.02f) {
+		gen.setSweep(rate, rate, 20000);
+		gen.seed(99);
+		int32_t count = measure<Encoder>(gen);
+		if (count != gen.position()) break;
+		last_ok = rate;
+	}
+	printf("\nmax trackable speed: %.0f counts/sec\n", last_ok);
+	return 0;
+}
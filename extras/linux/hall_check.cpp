@@ -0,0 +1,134 @@
+/* Encoder Library - EncoderHall decoding against a reference model
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Drives EncoderHall through simulated sensor pins, and checks the
+// position, sector() and invalid() against a simple model written
+// from the rules in EncoderHall.h:
+//
+//   table     all 64 old/new sensor codes, valid and impossible
+//   random    a motor turning both ways, sometimes skipping a sector
+//             (a missed edge), jumping 3 sectors, or glitching to the
+//             impossible codes 000 and 111
+//
+//   g++ -O2 -I../.. hall_check.cpp -o hall_check
+//   ./hall_check
+
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <EncoderHall.h>
+#include <stdio.h>
+
+typedef BasicEncoderHall<EncoderPolledTraits> PolledHall;
+
+// valid sensor codes (C B A) in forward order, sectors 0 to 5
+static const uint8_t code_of[6] = {1, 3, 2, 6, 4, 5};
+
+static uint8_t sector_model(uint8_t code) {
+	for (uint8_t i=0; i < 6; i++) {
+		if (code_of[i] == code) return i;
+	}
+	return ENCODER_HALL_NO_SECTOR;
+}
+
+// change of position from old to new code, or ENCODER_HALL_INVALID
+static int8_t delta_model(uint8_t from, uint8_t to) {
+	bool from_ok = sector_model(from) != ENCODER_HALL_NO_SECTOR;
+	bool to_ok = sector_model(to) != ENCODER_HALL_NO_SECTOR;
+	if (from == to) return 0;
+	if (!to_ok) return ENCODER_HALL_INVALID;
+	if (!from_ok) return 0;		// only resyncs
+	switch ((sector_model(to) + 6 - sector_model(from)) % 6) {
+		case 1: return 1;
+		case 2: return 2;
+		case 4: return -2;
+		case 5: return -1;
+	}
+	return ENCODER_HALL_INVALID;	// 3 sectors, no known direction
+}
+
+static void set_code(uint8_t code) {
+	volatile uint8_t *levels = encoder_linux_levels();
+	levels[0] = code & 1;
+	levels[1] = (code >> 1) & 1;
+	levels[2] = (code >> 2) & 1;
+}
+
+static uint32_t rng = 86420;
+static uint32_t random32() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+int main() {
+	int errors = 0;
+
+	// every old code to every new code
+	uint32_t invalid_count = 0;
+	for (uint8_t from=0; from < 8; from++) {
+		for (uint8_t to=0; to < 8; to++) {
+			set_code(from);
+			PolledHall hall(0, 1, 2);
+			hall.write(100);
+			set_code(to);
+			int32_t pos = hall.read();
+			uint32_t inv = hall.invalid();
+			int8_t d = delta_model(from, to);
+			int32_t want_pos = 100 + ((d == ENCODER_HALL_INVALID) ? 0 : d);
+			uint32_t want_inv = (d == ENCODER_HALL_INVALID) ? 1 : 0;
+			invalid_count += want_inv;
+			if ((pos != want_pos || inv != want_inv || hall.sector() != sector_model(to))
+			  && errors++ < 5) {
+				printf("error: code %u to %u, position %d, invalid %u, sector %u\n",
+					from, to, pos - 100, inv, hall.sector());
+			}
+		}
+	}
+	printf("table   64 changes, %u impossible: %s\n", invalid_count, errors ? "FAIL" : "ok");
+
+	// a turning motor, with skipped sectors and glitches
+	int table_errors = errors;
+	set_code(code_of[0]);
+	PolledHall hall(0, 1, 2);
+	uint8_t code = code_of[0];
+	uint8_t sector = 0;
+	int32_t want_pos = 0;
+	uint32_t want_inv = 0;
+	int8_t dir = 1;
+	for (uint32_t step=0; step < 500000; step++) {
+		uint32_t r = random32();
+		if (r % 1000 == 0) dir = -dir;
+		uint8_t next;
+		if ((r >> 10) % 200 == 0) {
+			next = ((r >> 20) & 1) ? 7 : 0;		// glitch
+		} else if ((r >> 10) % 200 == 1) {
+			sector = (sector + 3) % 6;		// 3 sectors at once
+			next = code_of[sector];
+		} else {
+			uint8_t n = ((r >> 10) % 50 == 2) ? 2 : 1;	// sometimes too fast
+			sector = (sector + 6 + dir * n) % 6;
+			next = code_of[sector];
+		}
+		int8_t d = delta_model(code, next);
+		if (d == ENCODER_HALL_INVALID) {
+			want_inv++;
+		} else {
+			want_pos += d;
+		}
+		code = next;
+		set_code(code);
+		int32_t pos = hall.read();
+		if ((pos != want_pos || hall.invalid() != want_inv
+		  || hall.sector() != sector_model(code)) && errors++ < 5) {
+			printf("error: step %u, code %u, position %d (want %d), invalid %u (want %u)\n",
+				step, code, pos, want_pos, hall.invalid(), want_inv);
+		}
+	}
+	printf("random  500000 changes, position %d, %u impossible: %s\n",
+		want_pos, want_inv, errors > table_errors ? "FAIL" : "ok");
+	return errors ? 1 : 0;
+}
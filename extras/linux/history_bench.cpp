@@ -0,0 +1,90 @@
+/* Encoder Library - EncoderHistory cost on the host
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Measures what EncoderHistory costs: the extra time per count when the
+// interrupt records every count, and the time of positionAt() for
+// several ring sizes, which should grow with log2(size).  Edges are fed
+// the way EncoderGpioEvents does, with a kernel style timestamp, so the
+// numbers are for update() itself.  examples/HistoryBench measures the
+// same on a board.
+//
+//   g++ -O2 -I../.. history_bench.cpp -o history_bench
+//   ./history_bench
+
+#include <EncoderLinuxGpio.h>
+#include <EncoderHistory.h>
+#include <stdio.h>
+#include <time.h>
+
+struct HistoryTraits : EncoderDefaultTraits {
+	static const bool history = true;
+};
+
+static double now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ns per edge, feeding edges on lines a and b like process() does
+static double edges(uint8_t a, uint8_t b, uint32_t count) {
+	static const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+	volatile uint8_t *levels = encoder_linux_levels();
+	encoder_linux_isr_t *vectors = encoder_linux_vectors();
+	double begin = now_ns();
+	for (uint32_t i=0; i < count; i++) {
+		uint8_t line = (i & 1) ? a : b;
+		levels[a] = seq[i & 3][0];
+		levels[b] = seq[i & 3][1];
+		encoder_linux_event_ns() = 1000 + (uint64_t)i * 2000;	// 500 kHz
+		(*vectors[line])(line);
+	}
+	encoder_linux_event_ns() = 0;
+	return (now_ns() - begin) / count;
+}
+
+template <uint16_t size>
+static void lookup(BasicEncoder<HistoryTraits> &enc) {
+	static EncoderHistory<size> h;
+	enc.setHistory(&h);
+	edges(2, 3, size * 2);		// fill it
+	uint32_t first = h.oldest(), span = (size - 1) * 2;
+	const uint32_t n = 2000000;
+	float sum = 0, p;
+	double begin = now_ns();
+	for (uint32_t i=0; i < n; i++) {
+		// spread over the whole ring
+		if (h.positionAt(first + (i * 7919) % span, p)) sum += p;
+	}
+	double ns = (now_ns() - begin) / n;
+	printf("  size %5u (%6u bytes)  positionAt %5.1f ns\n",
+		size, (unsigned)sizeof(h), ns);
+	if (sum == 0) printf("?\n");
+	enc.setHistory(0);
+}
+
+int main() {
+	const uint32_t n = 10000000;
+	Encoder plain;
+	BasicEncoder<HistoryTraits> recorded;
+	plain.begin(0, 1);
+	recorded.begin(2, 3);
+	EncoderHistory<256> h;
+	recorded.setHistory(&h);
+	edges(0, 1, n / 10);	// warm up
+	double base = edges(0, 1, n);
+	double with = edges(2, 3, n);
+	printf("update() per count: %.1f ns, with history %.1f ns (+%.1f ns)\n",
+		base, with, with - base);
+	if (plain.read() + recorded.read() == 12345) printf("?\n");
+	recorded.setHistory(0);
+	lookup<16>(recorded);
+	lookup<64>(recorded);
+	lookup<256>(recorded);
+	lookup<1024>(recorded);
+	lookup<4096>(recorded);
+	return 0;
+}
@@ -0,0 +1,288 @@
+/* Encoder Library - EncoderJournal power loss test
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Runs EncoderJournal on flash emulated in a file (EncoderJournalFile):
+//
+//   restore   random moves, some beyond the 24 bit record range, with a
+//             reboot every so often.  begin() must give back exactly
+//             the last saved position.
+//   torn      thousands of power cuts at a random byte of a record,
+//             header or erase.  After each, begin() must give back the
+//             position saved before the cut, or the one being written,
+//             never anything else.
+//   brownout  the same, but first a brownout interrupt calls flush() at
+//             a random byte of a write, with the encoder moved again.
+//             begin() must give back one of the 3 positions.
+//   policy    simulated time: a machine which moves then stops, 100
+//             times, writes once per stop with the default policy.
+//   wear      erases per sector after many records, which should be
+//             equal within 1, and the time begin() takes.
+//
+//   g++ -O2 -I../.. journal_test.cpp -o journal_test
+//   ./journal_test [file]
+
+#include <EncoderLinuxGpio.h>
+#include <EncoderJournal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SECTOR	256
+#define SECTORS	8
+
+// counts erases of each sector, and can interrupt a write at any byte
+class CountingFile : public EncoderJournalFile
+{
+public:
+	CountingFile() : interrupt(0), countdown(-1) { }
+	void erase(uint16_t sector) {
+		if (!powerLost()) erased[sector]++;
+		tick();
+		EncoderJournalFile::erase(sector);
+	}
+	void program(uint32_t address, const uint8_t *data, uint16_t length) {
+		for (uint16_t i=0; i < length; i++) {
+			tick();
+			EncoderJournalFile::program(address + i, data + i, 1);
+		}
+	}
+	// run f once, before the n-th byte programmed or sector erased from
+	// now, in the middle of the write which does it
+	void interruptAfter(int32_t n, void (*f)(void)) {
+		interrupt = f;
+		countdown = n;
+	}
+	uint32_t erased[SECTORS];
+private:
+	void tick() {
+		if (countdown >= 0 && countdown-- == 0) (*interrupt)();
+	}
+	void (*interrupt)(void);
+	int32_t countdown;
+};
+
+typedef BasicEncoderJournal<Encoder, CountingFile> Journal;
+
+static uint32_t rng = 99;
+static uint32_t random32() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static int32_t random_move() {
+	uint32_t r = random32();
+	if ((r & 0xFF) == 0) return (int32_t)random32();	// far, new sector
+	return (int32_t)(r >> 20) - 2048;
+}
+
+static Encoder enc;
+
+// power up: the Encoder starts from 0, then the journal restores it
+static int32_t boot(CountingFile &flash, bool &found) {
+	flash.powerOn();
+	enc.write(0);
+	Journal journal(enc, flash);
+	found = journal.begin();
+	return enc.read();
+}
+
+static bool restore(CountingFile &flash) {
+	uint32_t errors = 0;
+	int32_t position = 0;
+	for (int run = 0; run < 500; run++) {
+		bool found;
+		int32_t got = boot(flash, found);
+		if (run > 0 && (!found || got != position)) errors++;
+		position = got;
+		Journal journal(enc, flash);
+		journal.begin();
+		int moves = random32() % 400;
+		for (int i=0; i < moves; i++) {
+			position += random_move();
+			enc.write(position);
+			journal.flush();
+		}
+	}
+	printf("restore: 500 reboots, %u wrong  %s\n", errors, errors ? "FAIL" : "ok");
+	return errors == 0;
+}
+
+static bool torn(CountingFile &flash) {
+	uint32_t errors = 0, older = 0, newer = 0, skipped = 0;
+	for (int cut = 0; cut < 5000; cut++) {
+		bool found;
+		int32_t position = boot(flash, found);
+		Journal journal(enc, flash);
+		journal.begin();
+		skipped += journal.skipped;
+		// some good writes, then the power fails during one
+		int moves = random32() % 50;
+		for (int i=0; i < moves; i++) {
+			position += random_move();
+			enc.write(position);
+			journal.flush();
+		}
+		flash.cutPowerAfter(random32() % (SECTOR + 16));
+		int32_t before = position, writing = position;
+		while (!flash.powerLost()) {
+			before = journal.savedPosition();
+			writing = before + random_move();
+			if (writing == before) writing++;
+			enc.write(writing);
+			journal.flush();
+		}
+		int32_t got = boot(flash, found);
+		if (got == before) {
+			older++;
+		} else if (got == writing) {
+			newer++;
+		} else {
+			errors++;
+		}
+	}
+	printf("torn: 5000 power cuts, restored the previous position %u times, the "
+		"one being written %u, wrong %u, %u bad records skipped  %s\n",
+		older, newer, errors, skipped, errors ? "FAIL" : "ok");
+	return errors == 0;
+}
+
+// the brownout interrupt: the encoder moved a little more, flush()
+// saves it if it can, then the power fails a few bytes later
+static Journal *brownout_journal;
+static CountingFile *brownout_flash;
+static int32_t brownout_position;
+static bool brownout_flushed;
+
+static void brownout() {
+	enc.write(brownout_position);
+	brownout_flushed = brownout_journal->flush();
+	brownout_flash->cutPowerAfter(random32() % 8);
+}
+
+static bool brownout_test(CountingFile &flash) {
+	uint32_t errors = 0, older = 0, newer = 0, latest = 0, flushed = 0;
+	brownout_flash = &flash;
+	for (int cut = 0; cut < 5000; cut++) {
+		bool found;
+		int32_t position = boot(flash, found);
+		Journal journal(enc, flash);
+		journal.begin();
+		brownout_journal = &journal;
+		int moves = random32() % 50;
+		for (int i=0; i < moves; i++) {
+			position += random_move();
+			enc.write(position);
+			journal.flush();
+		}
+		// the interrupt comes during a record, a header or an erase
+		brownout_flushed = false;
+		flash.interruptAfter(random32() % (SECTOR / 4), brownout);
+		int32_t before = position, writing = position;
+		while (!flash.powerLost()) {
+			before = journal.savedPosition();
+			writing = before + random_move();
+			if (writing == before) writing++;
+			brownout_position = writing + 1 + (random32() & 0xFF);
+			enc.write(writing);
+			journal.flush();
+		}
+		if (brownout_flushed) flushed++;
+		int32_t got = boot(flash, found);
+		if (got == before) {
+			older++;
+		} else if (got == writing) {
+			newer++;
+		} else if (got == brownout_position) {
+			latest++;
+		} else {
+			errors++;
+		}
+	}
+	printf("brownout: 5000 flush() calls during a write, restored the previous "
+		"position %u times, the one being written %u, the flushed one %u "
+		"(%u flushed), wrong %u  %s\n",
+		older, newer, latest, flushed, errors, errors ? "FAIL" : "ok");
+	return errors == 0;
+}
+
+static bool policy(CountingFile &flash) {
+	bool found;
+	boot(flash, found);
+	Journal journal(enc, flash);
+	journal.begin();
+	uint32_t before = journal.records;
+	uint64_t ns = 1000000000ull;
+	int32_t position = enc.read();
+	for (int stop = 0; stop < 100; stop++) {
+		// move 1 count per ms for 2 seconds, then stand still 1 second
+		for (int ms = 0; ms < 3000; ms++) {
+			if (ms < 2000) enc.write(++position);
+			ns += 1000000;
+			encoder_linux_event_ns() = ns;	// micros() follows this
+			journal.update();
+		}
+	}
+	encoder_linux_event_ns() = 0;
+	uint32_t writes = journal.records - before;
+	bool ok = writes >= 100 && writes <= 101 && journal.savedPosition() == position;
+	printf("policy: 100 stops, %u writes (%u bytes)  %s\n", writes,
+		writes * ENCODER_JOURNAL_RECORD, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool wear(CountingFile &flash) {
+	bool found;
+	boot(flash, found);
+	for (int i=0; i < SECTORS; i++) flash.erased[i] = 0;
+	Journal journal(enc, flash);
+	journal.begin();
+	int32_t position = enc.read();
+	for (int i=0; i < 100000; i++) {
+		position += 1 + (random32() & 7);
+		enc.write(position);
+		journal.flush();
+	}
+	uint32_t lo = 0xFFFFFFFF, hi = 0;
+	for (int i=0; i < SECTORS; i++) {
+		if (flash.erased[i] < lo) lo = flash.erased[i];
+		if (flash.erased[i] > hi) hi = flash.erased[i];
+	}
+	struct timespec t0, t1;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	int32_t got = boot(flash, found);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	double us = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_nsec - t0.tv_nsec) / 1e3;
+	bool ok = hi - lo <= 1 && got == position;
+	printf("wear: 100000 records, erases per sector %u to %u, begin() %.0f us "
+		"(reads %u headers + 1 sector)  %s\n", lo, hi, us, SECTORS, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(int argc, char **argv) {
+	const char *path = (argc > 1) ? argv[1] : "journal_test.bin";
+	unlink(path);
+	CountingFile flash;
+	if (!flash.open(path, SECTOR, SECTORS)) {
+		perror(path);
+		return 1;
+	}
+	for (int i=0; i < SECTORS; i++) flash.erased[i] = 0;
+	enc.begin(0, 1);
+	bool ok = true;
+	bool found;
+	boot(flash, found);
+	if (found) ok = false;	// a new file holds no journal
+	ok &= restore(flash);
+	ok &= torn(flash);
+	ok &= brownout_test(flash);
+	ok &= policy(flash);
+	ok &= wear(flash);
+	flash.close();
+	unlink(path);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+/* Encoder Library - Linux GPIO Example
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Basic example for single board computers running Linux, like the
+// Raspberry Pi.  Pins are line offsets on the gpiochip, usually the
+// same as the BCM GPIO numbers on a Raspberry Pi.
+//
+//   g++ -O2 -I../.. knob.cpp -o knob
+//   ./knob /dev/gpiochip0 17 27
+
+#include <EncoderLinuxGpio.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv) {
+	if (argc < 4) {
+		fprintf(stderr, "usage: %s /dev/gpiochipN line1 line2\n", argv[0]);
+		return 1;
+	}
+	uint8_t lines[2];
+	lines[0] = atoi(argv[2]);
+	lines[1] = atoi(argv[3]);
+
+	EncoderGpioEvents gpio;
+	if (!gpio.open(argv[1], lines, 2)) {
+		perror(argv[1]);
+		return 1;
+	}
+	// begin() after open(), so the initial state is the real pin levels
+	Encoder knob;
+	knob.begin(lines[0], lines[1]);
+
+	int32_t old = -999;
+	while (gpio.process() > 0) {
+		int32_t pos = knob.read();
+		if (pos != old) {
+			old = pos;
+			printf("%d\n", pos);
+		}
+	}
+	perror("read");
+	return 1;
+}
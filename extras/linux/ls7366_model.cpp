@@ -0,0 +1,214 @@
+/* Encoder Library - EncoderLS7366 against a model of the chip
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Runs EncoderLS7366 on the host, talking to a register level model of
+// LS7366R chips instead of real ones.  The model decodes every
+// instruction byte the way the datasheet describes, and complains about
+// anything a real chip would not accept: unknown instructions, wrong
+// byte counts, more than 1 chip selected, or bytes outside a
+// transaction.  Random counts are fed to the chips, and every update()
+// must return them exactly, including across 32 bit wrap around.
+//
+//   g++ -O2 -I../.. ls7366_model.cpp -o ls7366_model
+//   ./ls7366_model
+
+#include <EncoderLS7366.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHIPS 3
+
+static int errors = 0;
+static void fail(const char *what, int chip) {
+	if (errors++ < 10) printf("error: %s, chip %d\n", what, chip);
+}
+
+class LS7366Model
+{
+public:
+	LS7366Model() : mdr0(0), mdr1(0), dtr(0), cntr(0), otr(0), str(0), total(0) { }
+	// quadrature edges seen by the chip
+	void edges(int32_t n) {
+		if (mdr1 & 0x04) return;	// counting disabled
+		// counts per 4 edges: x1, x2, x4, or every pulse in
+		// non-quadrature mode (0)
+		static const int per4[4] = {4, 1, 2, 4};
+		int64_t before = floor4(total * per4[mdr0 & 3]);
+		total += n;
+		int64_t after = floor4(total * per4[mdr0 & 3]);
+		cntr = (cntr + (uint32_t)(after - before)) & mask();
+	}
+	void select() { position = 0; }
+	uint8_t transfer(uint8_t in, int chip) {
+		uint8_t out = 0;
+		if (position == 0) {
+			instruction = in;
+		} else {
+			uint8_t op = instruction & 0xC0, reg = instruction & 0x38;
+			uint8_t n = position - 1;
+			if (op == LS7366_RD) {
+				if (n >= size(reg)) fail("read past register", chip);
+				out = (uint8_t)(value(reg) >> (8 * (size(reg) - 1 - n)));
+			} else if (op == LS7366_WR) {
+				if (n >= size(reg)) fail("write past register", chip);
+				write(reg, n, in, chip);
+			} else {
+				fail("data after CLR or LOAD", chip);
+			}
+		}
+		position++;
+		return out;
+	}
+	void deselect(int chip) {
+		uint8_t op = instruction & 0xC0, reg = instruction & 0x38;
+		if (position == 0) {
+			fail("selected without an instruction", chip);
+			return;
+		}
+		if (op == LS7366_CLR) {
+			if (reg == LS7366_MDR0) mdr0 = 0;
+			else if (reg == LS7366_MDR1) mdr1 = 0;
+			else if (reg == LS7366_CNTR) cntr = 0;
+			else if (reg == LS7366_STR) str = 0;
+			else fail("bad CLR register", chip);
+		} else if (op == LS7366_LOAD) {
+			if (reg == LS7366_CNTR) cntr = dtr & mask();
+			else if (reg == LS7366_OTR) otr = cntr;
+			else fail("bad LOAD register", chip);
+		} else if (op == LS7366_RD || op == LS7366_WR) {
+			if (position - 1 != size(reg)) fail("wrong number of data bytes", chip);
+		}
+	}
+	uint8_t mdr0, mdr1;
+	uint32_t dtr, cntr, otr;
+	uint8_t str;
+private:
+	// counter, DTR and OTR are 4 to 1 bytes, set by MDR1 bits 1-0
+	uint8_t bytes() const { return 4 - (mdr1 & 3); }
+	uint32_t mask() const { return bytes() == 4 ? 0xFFFFFFFF : ((uint32_t)1 << (8 * bytes())) - 1; }
+	uint8_t size(uint8_t reg) const {
+		return (reg == LS7366_MDR0 || reg == LS7366_MDR1 || reg == LS7366_STR) ? 1 : bytes();
+	}
+	uint32_t value(uint8_t reg) const {
+		switch (reg) {
+			case LS7366_MDR0: return mdr0;
+			case LS7366_MDR1: return mdr1;
+			case LS7366_OTR: return otr;
+			case LS7366_STR: return str;
+		}
+		// the real chip can only read CNTR through OTR
+		return 0;
+	}
+	void write(uint8_t reg, uint8_t n, uint8_t in, int chip) {
+		switch (reg) {
+			case LS7366_MDR0: mdr0 = in; return;
+			case LS7366_MDR1: mdr1 = in; return;
+			case LS7366_DTR:
+				if (n == 0) dtr = 0;
+				dtr = (dtr << 8) | in;
+				return;
+		}
+		fail("register is not writable", chip);
+	}
+	static int64_t floor4(int64_t x) { return (x >= 0 ? x : x - 3) / 4; }
+	int64_t total;		// edges
+	uint8_t instruction;
+	uint8_t position;
+};
+
+// Bus for EncoderLS7366, with the chips selected by "pins" 0 to CHIPS-1
+class ModelBus
+{
+public:
+	ModelBus() : transactions(0), bytes(0), in_transaction(false), selected(-1) { }
+	void begin() { }
+	void setupSelect(uint8_t pin) { if (pin >= CHIPS) fail("bad select pin", pin); }
+	void beginTransaction() {
+		if (in_transaction) fail("nested transaction", -1);
+		in_transaction = true;
+		transactions++;
+	}
+	void endTransaction() {
+		if (selected >= 0) fail("transaction ended with a chip selected", selected);
+		in_transaction = false;
+	}
+	void select(uint8_t pin) {
+		if (!in_transaction) fail("select outside a transaction", pin);
+		if (selected >= 0) fail("2 chips selected", pin);
+		selected = pin;
+		chip[pin].select();
+	}
+	void deselect(uint8_t pin) {
+		if (selected != pin) fail("deselect of an unselected chip", pin);
+		chip[pin].deselect(pin);
+		selected = -1;
+	}
+	void transfer(uint8_t *data, uint8_t n) {
+		if (selected < 0) fail("transfer with no chip selected", -1);
+		for (uint8_t i=0; i < n; i++) data[i] = chip[selected].transfer(data[i], selected);
+		bytes += n;
+	}
+	LS7366Model chip[CHIPS];
+	uint32_t transactions, bytes;
+private:
+	bool in_transaction;
+	int selected;
+};
+
+int main() {
+	const uint8_t selects[CHIPS] = {0, 1, 2};
+	ModelBus bus;
+	EncoderLS7366<ModelBus, CHIPS> axes(bus, selects);
+	// junk in the chips, as after power up
+	for (int i=0; i < CHIPS; i++) bus.chip[i].cntr = 12345 * (i + 1);
+	axes.begin();
+	for (int i=0; i < CHIPS; i++) {
+		if (bus.chip[i].mdr0 != LS7366_X4) fail("MDR0 not x4", i);
+		if (bus.chip[i].mdr1 != LS7366_MDR1_4BYTE) fail("MDR1 not 4 byte", i);
+		if (bus.chip[i].cntr != 0) fail("counter not cleared", i);
+	}
+
+	// random motion, checked after every update()
+	int32_t expect[CHIPS] = {0, 0, 0};
+	srand(1);
+	uint32_t before = bus.transactions, bytes = bus.bytes;
+	const int updates = 100000;
+	for (int u=0; u < updates; u++) {
+		for (int i=0; i < CHIPS; i++) {
+			// up to 100 million edges/sec for 1 ms, either way
+			int32_t n = rand() % 200001 - 100000;
+			bus.chip[i].edges(n);
+			expect[i] = (int32_t)((uint32_t)expect[i] + (uint32_t)n);
+		}
+		axes.update();
+		for (int i=0; i < CHIPS; i++) {
+			if (axes.read(i) != expect[i]) fail("wrong count", i);
+		}
+		if (u == updates / 2) {
+			// write() and readAndReset() keep counting from the chip
+			axes.write(0, 1000);
+			expect[0] = 1000;
+			if (axes.readAndReset(1) != expect[1]) fail("readAndReset", 1);
+			expect[1] = 0;
+			EncoderChannel<EncoderLS7366<ModelBus, CHIPS> > z = axes.encoder(2);
+			if (z.read() != expect[2]) fail("channel read", 2);
+		}
+	}
+	// drive 1 axis past the 32 bit limit
+	for (int k=0; k < 3; k++) {
+		bus.chip[0].edges(0x60000000);
+		expect[0] = (int32_t)((uint32_t)expect[0] + 0x60000000u);
+		axes.update();
+		if (axes.read(0) != expect[0]) fail("wrong count after wrap", 0);
+	}
+	uint32_t used = bus.transactions - before;
+	printf("%d updates of %d chips: %u SPI transactions, %.1f bytes each\n",
+		updates + 3, CHIPS, used, (double)(bus.bytes - bytes) / used);
+	printf("at 4 MHz SPI an update takes about %.1f us plus select time\n",
+		(double)(bus.bytes - bytes) / used * 8 / 4.0);
+	printf("%s, %d errors\n", errors ? "FAILED" : "ok", errors);
+	return errors ? 1 : 0;
+}
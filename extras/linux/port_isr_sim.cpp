@@ -0,0 +1,247 @@
+/* Encoder Library - ENCODER_OPTIMIZE_INTERRUPTS port handlers on the host
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Runs the Teensy port interrupt code from utility/interrupt_config.h
+// against simulated registers: Kinetis PORTx_PCRn and PORTx_ISFR for
+// Teensy 3.x and LC, or i.MX RT GPIOn DR/IMR/ISR/EDGE_SEL for Teensy 4.
+// Flag registers are write 1 to clear, like the hardware, so a flag the
+// handler forgets to clear stays pending.  Checks that
+//
+//   attach()   configures the pin for both edges and clears old flags
+//   service()  updates each encoder once, with several pins pending on
+//              the same port, and only encoders with a pending pin
+//   flags      are all clear afterwards, except on Teensy 4 those of
+//              pins which are not Encoder's (IMR bit clear)
+//   slots      an encoder beyond ENCODER_PORT_SLOTS is refused
+//
+// Build one of:
+//
+//   g++ -O2 -I../.. port_isr_sim.cpp -o port_isr_sim                 (3.x)
+//   g++ -O2 -I../.. -DSIM_KINETISL port_isr_sim.cpp -o port_isr_sim  (LC)
+//   g++ -O2 -I../.. -DSIM_IMXRT port_isr_sim.cpp -o port_isr_sim     (4.x)
+//   ./port_isr_sim
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEENSYDUINO 159
+#define ENCODER_PORT_SLOTS 4
+
+// write 1 to clear
+struct SimFlags {
+	uint32_t pending;
+	operator uint32_t() const { return pending; }
+	void operator=(uint32_t v) { pending &= ~v; }
+};
+
+static void (*vector[8])(void);
+static bool enabled[8];
+#define attachInterruptVector(irq, f) (vector[irq] = (f))
+#define NVIC_ENABLE_IRQ(irq) (enabled[irq] = true)
+#define __disable_irq()
+#define __enable_irq()
+
+#if defined(SIM_IMXRT)
+#define __IMXRT1062__
+// 4 ports, 16K apart, registers as 32 bit words from DR
+static uint32_t sim_gpio[4][4096];
+#define GPIO6_DR sim_gpio[0][0]
+#define GPIO7_DR sim_gpio[1][0]
+#define GPIO8_DR sim_gpio[2][0]
+#define GPIO9_DR sim_gpio[3][0]
+enum { IRQ_GPIO6789 };
+// pin p is bit p % 32 of GPIO6 + p / 32
+#define portOutputRegister(pin) ((volatile uint32_t *)&sim_gpio[(pin) / 32][0])
+#define digitalPinToBitMask(pin) ((uint32_t)1 << ((pin) % 32))
+#define IMR	5
+#define ISR	6
+#define EDGE	7
+#else
+#if defined(SIM_KINETISL)
+#define KINETISL
+enum { IRQ_PORTA, IRQ_PORTCD };
+#else
+#define KINETISK
+enum { IRQ_PORTA, IRQ_PORTB, IRQ_PORTC, IRQ_PORTD, IRQ_PORTE };
+#endif
+// 5 ports, 4K apart, 32 PCR registers each
+static uint32_t pcr[5][1024];
+static SimFlags isfr[5];
+#define PORTA_PCR0 pcr[0][0]
+#define PORTA_ISFR isfr[0]
+#define PORTB_ISFR isfr[1]
+#define PORTC_ISFR isfr[2]
+#define PORTD_ISFR isfr[3]
+#define PORTE_ISFR isfr[4]
+// pin p is bit p % 32 of port C + p / 32, so pins 0-63 are on C and D
+#define portConfigRegister(pin) (&pcr[2 + (pin) / 32][(pin) % 32])
+#endif
+
+#include <utility/interrupt_config.h>
+
+struct SimState {
+	int updates;
+};
+
+struct SimDecoder {
+	static void update(SimState *s) { s->updates++; }
+};
+
+typedef EncoderPorts<SimState, SimDecoder> Ports;
+
+static int errors = 0;
+static void check(bool ok, const char *what) {
+	if (!ok && errors++ < 10) printf("error: %s\n", what);
+}
+
+static uint8_t port_of(uint8_t pin) {
+#if defined(SIM_IMXRT)
+	return pin / 32;
+#else
+	return 2 + pin / 32;
+#endif
+}
+
+// an edge on a pin, as the hardware would flag it
+static void edge(uint8_t pin) {
+#if defined(SIM_IMXRT)
+	sim_gpio[pin / 32][ISR] |= (uint32_t)1 << (pin % 32);
+#else
+	isfr[port_of(pin)].pending |= (uint32_t)1 << (pin % 32);
+#endif
+}
+
+// the interrupt controller: run the vector for a pin's port
+static void run(uint8_t pin) {
+#if defined(SIM_IMXRT)
+	(*vector[IRQ_GPIO6789])();
+	(void)pin;
+#elif defined(SIM_KINETISL)
+	(*vector[(port_of(pin) == 0) ? IRQ_PORTA : IRQ_PORTCD])();
+#else
+	(*vector[port_of(pin)])();
+#endif
+}
+
+#if defined(SIM_IMXRT)
+// sim_gpio[][ISR] is plain memory, so make it write 1 to clear by hand.
+// Bit 31 is flagged on every port but never in IMR, so service() never
+// writes it: if it is gone, service() wrote the register, and the bits
+// it wrote are cleared from what was pending.
+static void run_w1c(uint8_t pin) {
+	uint32_t before[4];
+	for (int i=0; i < 4; i++) before[i] = sim_gpio[i][ISR] |= 0x80000000;
+	run(pin);
+	for (int i=0; i < 4; i++) {
+		uint32_t after = sim_gpio[i][ISR];
+		if (!(after & 0x80000000)) after = before[i] & ~after;
+		sim_gpio[i][ISR] = after & 0x7FFFFFFF;
+	}
+}
+#define RUN run_w1c
+static uint32_t pending(uint8_t port) { return sim_gpio[port][ISR]; }
+#else
+#define RUN run
+static uint32_t pending(uint8_t port) { return isfr[port].pending; }
+#endif
+
+int main() {
+	SimState enc[6];
+	memset(enc, 0, sizeof(enc));
+	// 4 encoders on the first port, pins (0,1) (2,3) (4,5) (6,7), the
+	// 5th (8,9) beyond ENCODER_PORT_SLOTS, and 1 on the second port
+	static const uint8_t pins[6][2] = {{0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {40,41}};
+	const uint8_t first = port_of(0), second = port_of(40);
+
+#if defined(SIM_IMXRT)
+	bool cleared = true;
+	for (int i=0; i < 6; i++) {
+		for (int j=0; j < 2; j++) {
+			uint8_t pin = pins[i][j];
+			sim_gpio[pin / 32][ISR] = 0;
+			Ports::attach(pin, &enc[i]);
+			// the only write must be the pin's own bit, clearing it
+			if (sim_gpio[pin / 32][ISR] != digitalPinToBitMask(pin)) cleared = false;
+			sim_gpio[pin / 32][ISR] = 0;
+		}
+	}
+	check(cleared, "attach clears the pin's old flag");
+	check(sim_gpio[first][IMR] == 0x3FF, "IMR has the attached pins");
+	check(sim_gpio[first][EDGE] == 0x3FF, "EDGE_SEL has the attached pins");
+	check(sim_gpio[second][IMR] == 0x300, "IMR on the second port");
+	check(enabled[IRQ_GPIO6789], "IRQ_GPIO6789 enabled");
+#else
+	for (int i=0; i < 6; i++) {
+		pcr[port_of(pins[i][0])][pins[i][0] % 32] = 0x01000103;	// ISF, MUX, pullup
+		isfr[port_of(pins[i][0])].pending |= 1 << (pins[i][0] % 32);
+		Ports::attach(pins[i][0], &enc[i]);
+		Ports::attach(pins[i][1], &enc[i]);
+	}
+	bool irqc = true;
+	for (int i=0; i < 6; i++) {
+		for (int j=0; j < 2; j++) {
+			uint32_t r = pcr[port_of(pins[i][j])][pins[i][j] % 32];
+			if (((r >> 16) & 0xF) != 0xB) irqc = false;
+		}
+	}
+	check(irqc, "PCR IRQC = 1011, both edges");
+	check(pcr[first][0] == 0x010B0103, "PCR keeps MUX and pullup, writes ISF");
+	// writing ISF to the PCR clears that flag, as the hardware does
+	for (int p=0; p < 5; p++) {
+		for (int b=0; b < 32; b++) {
+			if (pcr[p][b] & 0x01000000) isfr[p].pending &= ~((uint32_t)1 << b);
+		}
+	}
+#if defined(SIM_KINETISL)
+	check(enabled[IRQ_PORTCD], "IRQ_PORTCD enabled");
+#else
+	check(enabled[IRQ_PORTC] && enabled[IRQ_PORTD], "IRQ_PORTC, IRQ_PORTD enabled");
+#endif
+#endif
+	check(Ports::ports[first].count == ENCODER_PORT_SLOTS, "port slots used");
+
+	// several pins pending at once on one port: both pins of encoder 0,
+	// 1 of encoder 2, and pin 20, which is not an encoder's
+	edge(0); edge(1); edge(4); edge(20);
+	RUN(0);
+	check(enc[0].updates == 1, "encoder 0 updated once for 2 pending pins");
+	check(enc[1].updates == 0, "encoder 1 not updated");
+	check(enc[2].updates == 1, "encoder 2 updated");
+	check(enc[3].updates == 0, "encoder 3 not updated");
+#if defined(SIM_IMXRT)
+	check(pending(first) == (1 << 20), "encoder flags cleared, others kept");
+	sim_gpio[first][ISR] = 0;
+#else
+	check(pending(first) == 0, "all flags cleared");
+#endif
+
+	// every encoder on the first port, and the second port too
+	edge(1); edge(3); edge(5); edge(6); edge(7); edge(8); edge(41);
+	RUN(1);
+#if !defined(SIM_KINETISL) && !defined(SIM_IMXRT)
+	RUN(41);	// C and D have separate vectors
+#endif
+	check(enc[0].updates == 2 && enc[1].updates == 1 && enc[2].updates == 2
+		&& enc[3].updates == 1, "every pending encoder updated");
+	check(enc[4].updates == 0, "encoder beyond ENCODER_PORT_SLOTS not counted");
+	check(enc[5].updates == 1, "second port serviced");
+	check(pending(first) == 0 && pending(second) == 0, "flags cleared on both ports");
+
+	// nothing pending: nothing updated
+	RUN(0);
+	check(enc[0].updates == 2 && enc[5].updates == 1, "no update without a flag");
+
+#if defined(SIM_IMXRT)
+	const char *board = "Teensy 4.x";
+#elif defined(SIM_KINETISL)
+	const char *board = "Teensy LC";
+#else
+	const char *board = "Teensy 3.x";
+#endif
+	printf("%s port interrupts: %s\n", board, errors ? "FAIL" : "ok");
+	return errors ? 1 : 0;
+}
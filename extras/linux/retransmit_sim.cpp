@@ -0,0 +1,238 @@
+/* Encoder Library - quadrature retransmit simulation
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Checks setRetransmit() on the host, in 3 parts:
+//
+//   ratio    the output lines feed a second, plain Encoder.  After every
+//            input edge its count must be exactly floor(input * multiply
+//            / divide), or the inverse with invert, through sweeps which
+//            reverse direction and miss some edges, for several integer and
+//            fractional ratios.
+//   latency  the same single CPU model as scale_bench: an edge makes its
+//            pin's interrupt pending, the CPU starts it after the entry
+//            latency, and toggles the output write_ns later.  The time
+//            from input edge to output edge is measured up to the rate
+//            where the interrupt can no longer keep up, and must stay
+//            within 2 * entry + service + write_ns, the worst case being
+//            an edge which arrives just as the other pin's interrupt
+//            starts, so it waits for all of that one first.
+//   cost     the real time of update() on this machine, with and without
+//            retransmit, fed the way EncoderGpioEvents does.
+//
+//   g++ -O2 -I../.. retransmit_sim.cpp -o retransmit_sim
+//   ./retransmit_sim [entry_ns] [service_ns] [write_ns]
+
+// every run begin()s the encoders again, no need to wait for the pins
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <EncoderGenerator.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct RetransmitTraits : EncoderDefaultTraits {
+	static const bool retransmit = true;
+};
+
+static uint32_t entry = 100, service = 400, write_ns = 150;	// ns
+
+#define IN_A	0
+#define IN_B	1
+#define OUT_A	10
+#define OUT_B	11
+
+static BasicEncoder<RetransmitTraits> input;
+static Encoder output;		// decodes the retransmitted signal
+
+// copy changed outputs to the lines the second encoder reads, returning
+// how many edges it saw.  After a +/-2 count both pins changed, 1 step
+// after the other, so replay them in that order: going up from an even
+// phase, or down from an odd one, B toggled first.
+static int follow(int8_t dir) {
+	volatile uint8_t *levels = encoder_linux_levels();
+	volatile uint8_t *outputs = encoder_linux_outputs();
+	uint8_t phase = (levels[OUT_A] << 1) | (levels[OUT_A] ^ levels[OUT_B]);
+	uint8_t first = ((phase & 1) == (dir < 0)) ? OUT_B : OUT_A;
+	uint8_t order[2] = {first, (uint8_t)(OUT_A + OUT_B - first)};
+	int n = 0;
+	for (int i=0; i < 2; i++) {
+		uint8_t line = order[i];
+		if (levels[line] != outputs[line]) {
+			levels[line] = outputs[line];
+			(*encoder_linux_vectors()[line])(line);
+			n++;
+		}
+	}
+	return n;
+}
+
+static int32_t floor_div(int64_t n, int64_t d) {
+	return (int32_t)((n >= 0) ? n / d : -((-n + d - 1) / d));
+}
+
+static void start(uint16_t multiply, uint16_t divide, bool invert) {
+	volatile uint8_t *levels = encoder_linux_levels();
+	levels[IN_A] = levels[IN_B] = levels[OUT_A] = levels[OUT_B] = 0;
+	input.begin(IN_A, IN_B);
+	output.begin(OUT_A, OUT_B);
+	input.setRetransmit(OUT_A, OUT_B, multiply, divide, invert);
+}
+
+static bool ratio(uint16_t multiply, uint16_t divide, bool invert) {
+	start(multiply, divide, invert);
+	EncoderSignalGenerator gen;
+	gen.setSweep(200000, -150000, 50000);	// forward, then back past 0
+	gen.setJitter(1000);
+	gen.setMissRate(0.01);			// some +/-2 counts
+	gen.seed(multiply * 31 + divide);
+	volatile uint8_t *levels = encoder_linux_levels();
+	EncoderSignalEdge e;
+	uint32_t edges = 0, errors = 0, most = 0;
+	bool more = gen.next(e);
+	while (more) {
+		// a missed edge comes at the same time as the next one, so
+		// update() sees both at once
+		uint64_t ns = e.ns;
+		uint8_t line;
+		do {
+			line = e.pin ? IN_B : IN_A;
+			levels[line] = e.level;
+			more = gen.next(e);
+		} while (more && e.ns == ns);
+		(*encoder_linux_vectors()[line])(line);
+		int32_t in = input.read();
+		int32_t want = floor_div((int64_t)(invert ? -in : in) * multiply, divide);
+		int n = follow((want > output.read()) ? 1 : -1);
+		if (n > (int)most) most = n;
+		if (output.read() != want) errors++;
+		edges++;
+	}
+	printf("  %5u / %-5u %-6s  %6u edges  input %6d  output %6d  "
+		"max %u out/in  %s\n", multiply, divide, invert ? "invert" : "",
+		edges, input.read(), output.read(), most,
+		errors ? "FAIL" : "ok");
+	return errors == 0;
+}
+
+struct Timing {
+	uint64_t edges;
+	uint64_t outputs;
+	uint64_t misses;	// input counted 2 at once
+	double latency_avg;	// input edge to output edge
+	double latency_max;
+};
+
+static Timing run(float rate, uint32_t micros_long) {
+	start(1, 1, false);
+	EncoderSignalGenerator gen;
+	gen.setSweep(rate, rate, micros_long);
+	gen.setJitter((uint32_t)(2.5e8f / rate));	// 1/4 step
+	gen.seed(7);
+	volatile uint8_t *levels = encoder_linux_levels();
+	uint64_t pending_since[2] = {0, 0};	// 0 = not pending
+	uint64_t cpu_free = 0;
+	Timing t = {0, 0, 0, 0, 0};
+	double latency_sum = 0;
+	EncoderSignalEdge next;
+	bool more = gen.next(next);
+	while (1) {
+		uint64_t t_edge = more ? next.ns : ~(uint64_t)0;
+		int p = -1;
+		if (pending_since[0]) p = 0;
+		if (pending_since[1] && (p < 0 || pending_since[1] < pending_since[0])) p = 1;
+		if (p >= 0) {
+			uint64_t begin = pending_since[p] > cpu_free ? pending_since[p] : cpu_free;
+			uint64_t read_at = begin + entry;
+			if (read_at <= t_edge) {
+				int32_t before = input.read();
+				(*encoder_linux_vectors()[p])(p);
+				int32_t d = input.read() - before;
+				if (d == 2 || d == -2) t.misses++;
+				if (follow(d)) {
+					double lat = (double)(read_at + write_ns - pending_since[p]);
+					latency_sum += lat;
+					if (lat > t.latency_max) t.latency_max = lat;
+					t.outputs++;
+				}
+				pending_since[p] = 0;
+				cpu_free = read_at + service;
+				continue;
+			}
+		}
+		if (!more) break;
+		uint8_t line = next.pin ? IN_B : IN_A;
+		levels[line] = next.level;
+		if (!pending_since[line]) pending_since[line] = next.ns ? next.ns : 1;
+		t.edges++;
+		more = gen.next(next);
+	}
+	t.latency_avg = t.outputs ? latency_sum / t.outputs : 0;
+	return t;
+}
+
+static double now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ns per edge, feeding edges on lines a and b like process() does
+static double edges(uint8_t a, uint8_t b, uint32_t count) {
+	static const uint8_t seq[4][2] = {{0,1}, {1,1}, {1,0}, {0,0}};
+	volatile uint8_t *levels = encoder_linux_levels();
+	encoder_linux_isr_t *vectors = encoder_linux_vectors();
+	double begin = now_ns();
+	for (uint32_t i=0; i < count; i++) {
+		uint8_t line = (i & 1) ? a : b;
+		levels[a] = seq[i & 3][0];
+		levels[b] = seq[i & 3][1];
+		(*vectors[line])(line);
+	}
+	return (now_ns() - begin) / count;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1) entry = atoi(argv[1]);
+	if (argc > 2) service = atoi(argv[2]);
+	if (argc > 3) write_ns = atoi(argv[3]);
+	bool ok = true;
+
+	printf("ratio: output count must be floor(input * multiply / divide)\n");
+	ok &= ratio(1, 1, false);
+	ok &= ratio(1, 1, true);
+	ok &= ratio(1, 4, false);
+	ok &= ratio(45, 128, false);
+	ok &= ratio(3, 8, true);
+	ok &= ratio(999, 1000, false);
+	ok &= !input.setRetransmit(OUT_A, OUT_B, 5, 4);	// above 1 is refused
+
+	uint32_t bound = 2 * entry + service + write_ns;
+	printf("\nlatency: entry %u ns, service %u ns, output write at +%u ns, "
+		"bound %u ns\n", entry, service, write_ns, bound);
+	printf("  edges/sec   latency avg/max ns  misses\n");
+	for (float rate = 100000; rate < 1e8f; rate *= 2) {
+		Timing t = run(rate, 20000);
+		printf("  %9.0f  %8.0f / %-8.0f  %llu\n", rate, t.latency_avg,
+			t.latency_max, (unsigned long long)t.misses);
+		if (t.misses) break;	// past the rate where outputs are valid
+		if (t.latency_max > bound) {
+			printf("  latency above the bound: FAIL\n");
+			ok = false;
+		}
+	}
+
+	const uint32_t n = 10000000;
+	Encoder plain;
+	plain.begin(20, 21);
+	start(1, 1, false);
+	edges(20, 21, n / 10);	// warm up
+	double base = edges(20, 21, n);
+	double with = edges(IN_A, IN_B, n);
+	printf("\ncost: update() per count %.1f ns, with retransmit %.1f ns (+%.1f ns)\n",
+		base, with, with - base);
+	if (plain.read() == 12345) printf("?\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/* Encoder Library - many encoder scalability simulation
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// How does throughput hold up as encoders are added?  This runs 1 to 30
+// real Encoder objects on the host, each fed its own quadrature signal
+// from EncoderSignalGenerator, with a single simulated CPU servicing
+// their pin interrupts one at a time:
+//
+//   - an edge makes its pin's interrupt pending, if it is not already
+//   - the CPU starts the oldest pending interrupt when free, after the
+//     entry latency, reads the pins, and is busy for the service time
+//   - edges on a pin while its interrupt is pending are merged, so
+//     update() sees 2 changes at once, a +/-2 step: a miss
+//
+// For each count, the rate per encoder is raised until misses appear or
+// the CPU is saturated, giving the max sustainable aggregate edges/sec,
+// with the interrupt latency (edge to pins read) at that rate.  Each
+// encoder's signal has its own seed and some jitter, so edges collide
+// the way independent encoders do.  Use your own timing numbers for the
+// board you are sizing.
+//
+//   g++ -O2 -I../.. scale_bench.cpp -o scale_bench
+//   ./scale_bench [entry_ns] [service_ns]
+
+// every run begin()s the encoders again, no need to wait for the pins
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <EncoderGenerator.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_ENCODERS 30
+
+static uint32_t entry = 100, service = 400;	// ns
+
+struct Stats {
+	uint64_t edges;
+	uint64_t misses;	// +/-2 steps seen by update()
+	int64_t error;		// total |true - counted|
+	double latency_avg;
+	double latency_max;
+	double busy;		// CPU fraction
+};
+
+static Encoder enc[MAX_ENCODERS];
+
+static Stats run(int count, float rate, uint32_t micros_long) {
+	EncoderSignalGenerator gen[MAX_ENCODERS];
+	EncoderSignalEdge next[MAX_ENCODERS];
+	bool more[MAX_ENCODERS];
+	uint64_t pending_since[2 * MAX_ENCODERS];	// 0 = not pending
+	volatile uint8_t *levels = encoder_linux_levels();
+	for (int i=0; i < count; i++) {
+		levels[2 * i] = levels[2 * i + 1] = 0;
+		enc[i].begin(2 * i, 2 * i + 1);
+		gen[i].setSweep(rate, rate, micros_long);
+		gen[i].setJitter((uint32_t)(2.5e8f / rate));	// 1/4 step
+		gen[i].seed(1000 + i);
+		more[i] = gen[i].next(next[i]);
+	}
+	for (int i=0; i < 2 * count; i++) pending_since[i] = 0;
+	Stats st = {0, 0, 0, 0, 0, 0};
+	uint64_t cpu_free = 0, busy = 0, serviced = 0;
+	double latency_sum = 0;
+	while (1) {
+		// earliest edge of any encoder
+		int e = -1;
+		for (int i=0; i < count; i++) {
+			if (more[i] && (e < 0 || next[i].ns < next[e].ns)) e = i;
+		}
+		uint64_t t_edge = (e >= 0) ? next[e].ns : ~(uint64_t)0;
+		// oldest pending interrupt
+		int p = -1;
+		for (int i=0; i < 2 * count; i++) {
+			if (pending_since[i] && (p < 0 || pending_since[i] < pending_since[p])) p = i;
+		}
+		if (p >= 0) {
+			uint64_t start = pending_since[p] > cpu_free ? pending_since[p] : cpu_free;
+			uint64_t read_at = start + entry;
+			if (read_at <= t_edge) {
+				// the interrupt reads the pins before the next edge
+				double lat = (double)(read_at - pending_since[p]);
+				latency_sum += lat;
+				if (lat > st.latency_max) st.latency_max = lat;
+				serviced++;
+				pending_since[p] = 0;
+				int n = p / 2;
+				int32_t before = enc[n].read();
+				(*encoder_linux_vectors()[p])(p);
+				int32_t d = enc[n].read() - before;
+				if (d == 2 || d == -2) st.misses++;
+				cpu_free = read_at + service;
+				busy += entry + service;
+				continue;
+			}
+		}
+		if (e < 0) break;
+		uint8_t line = 2 * e + next[e].pin;
+		levels[line] = next[e].level;
+		if (!pending_since[line]) pending_since[line] = next[e].ns ? next[e].ns : 1;
+		st.edges++;
+		more[e] = gen[e].next(next[e]);
+	}
+	for (int i=0; i < count; i++) {
+		int32_t d = gen[i].position() - enc[i].read();
+		st.error += (d < 0) ? -d : d;
+	}
+	st.latency_avg = serviced ? latency_sum / serviced : 0;
+	st.busy = (double)busy / ((double)micros_long * 1000);
+	return st;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1) entry = atoi(argv[1]);
+	if (argc > 2) service = atoi(argv[2]);
+	printf("interrupt entry %u ns, service %u ns\n\n", entry, service);
+	printf("encoders  max rate each  aggregate edges/sec  CPU   latency avg/max ns  "
+		"miss rate at 2x\n");
+	int counts[] = {1, 2, 4, 8, 12, 16, 20, 24, 30};
+	for (unsigned c=0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		int n = counts[c];
+		float ok = 0;
+		Stats ok_stats = {0, 0, 0, 0, 0, 0};
+		for (float rate = 1000; rate < 1e7f; rate *= 1.1f) {
+			Stats st = run(n, rate, 20000);
+			if (st.misses || st.error || st.busy > 0.95) break;
+			ok = rate;
+			ok_stats = st;
+		}
+		Stats over = run(n, ok * 2, 20000);
+		printf("%8d  %13.0f  %19.0f  %3.0f%%  %8.0f / %-8.0f  %.2f%%\n",
+			n, ok, ok * n, ok_stats.busy * 100,
+			ok_stats.latency_avg, ok_stats.latency_max,
+			over.edges ? 100.0 * over.misses / over.edges : 0);
+	}
+	return 0;
+}
@@ -0,0 +1,124 @@
+/* Encoder Library - EncoderScale against exact rational arithmetic
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Checks EncoderRatio's multiply-shift conversion against floor(counts *
+// num * 2^bits / den) done exactly with 128 bit integers, for several
+// ratios: every count from -2^20 to 2^20, then random counts over the
+// whole 32 bit range.  Within +/- exact_limit every result must be
+// exact, beyond it at most 1 unit high.  Velocity ratios are checked
+// the same way, then the time per conversion is compared with float and
+// with a 64 bit divide.
+//
+//   g++ -O2 -I../.. scale_check.cpp -o scale_check
+//   ./scale_check
+
+#include <EncoderLinuxGpio.h>
+#include <EncoderScale.h>
+#include <stdio.h>
+#include <time.h>
+
+static uint32_t rng = 12345;
+static uint32_t next_random() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static __int128 floor_div(__int128 n, __int128 d) {
+	__int128 q = n / d;
+	if ((n % d) && (n < 0)) q--;
+	return q;
+}
+
+struct Result {
+	uint32_t tested;
+	uint32_t exact_errors;	// wrong within exact_limit
+	uint32_t outside_errors;	// beyond it, not 0 or +1
+	uint32_t off_by_one;	// beyond it, +1
+};
+
+template <class C>
+static void check_one(int32_t c, Result &r) {
+	__int128 want = floor_div((__int128)c * C::numerator, C::denominator);
+	if (want > 0x7FFFFFFF || want < -(__int128)0x80000000) return;	// doesn't fit
+	int32_t got = C::convert(c);
+	r.tested++;
+	__int128 diff = (__int128)got - want;
+	bool inside = c <= C::exact_limit && c >= -C::exact_limit;
+	if (inside) {
+		if (diff) r.exact_errors++;
+	} else if (diff == 1) {
+		r.off_by_one++;
+	} else if (diff) {
+		r.outside_errors++;
+	}
+}
+
+template <class C>
+static bool check(const char *name) {
+	Result r = {0, 0, 0, 0};
+	for (int32_t c = -(1 << 20); c <= (1 << 20); c++) check_one<C>(c, r);
+	for (uint32_t i=0; i < 4000000; i++) check_one<C>((int32_t)next_random(), r);
+	check_one<C>(0x7FFFFFFF, r);
+	check_one<C>(-0x7FFFFFFF - 1, r);
+	bool ok = !r.exact_errors && !r.outside_errors;
+	printf("  %-28s %llu/%llu  exact to +/-%-10d %8u tested  %u +1 beyond  %s\n",
+		name, (unsigned long long)C::numerator, (unsigned long long)C::denominator,
+		C::exact_limit, r.tested, r.off_by_one, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static double now_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef EncoderRatio<360, 4096, 16> Degrees;
+
+int main() {
+	bool ok = true;
+	printf("position, units per count:\n");
+	ok &= check<EncoderRatio<5, 2> >("2.5 um");
+	ok &= check<EncoderRatio<1, 3> >("1/3");
+	ok &= check<Degrees>("degrees Q16, 4096 cpr");
+	ok &= check<EncoderRatio<360, 3600, 16> >("degrees Q16, 3600 cpr");
+	ok &= check<EncoderRatio<254, 1000, 8> >("0.254 mm, 1/256 mm");
+	ok &= check<EncoderRatio<1000000, 999983> >("near 1, large prime");
+	ok &= check<EncoderRatio<7, 1> >("whole number");
+	ok &= check<EncoderRatio<1, 4294967291u> >("tiny");
+
+	printf("velocity, units per second from counts per period:\n");
+	ok &= check<Encoder_rate_constants<EncoderRatio<5, 2>, 1000>::type>("2.5 um, 1 ms");
+	ok &= check<Encoder_rate_constants<EncoderRatio<254, 1000, 8>, 2500>::type>("0.254 mm, 2.5 ms");
+	ok &= check<Encoder_rate_constants<EncoderRatio<1, 3>, 7>::type>("1/3, 7 us");
+
+	Encoder knob;
+	knob.begin(0, 1);
+	BasicEncoderScale<Encoder, EncoderRatio<5, 2>, 1000> axis(knob);
+	axis.sample();
+	ok &= axis.read() == 0 && axis.readVelocity() == 0;
+
+	const uint32_t n = 20000000;
+	static int32_t counts[1024];
+	for (int i=0; i < 1024; i++) counts[i] = (int32_t)(next_random() >> 8) - 0x800000;
+	volatile int32_t sink = 0;
+	double t0 = now_ns();
+	for (uint32_t i=0; i < n; i++) sink += Degrees::convert(counts[i & 1023]);
+	double t1 = now_ns();
+	for (uint32_t i=0; i < n; i++) sink += (int32_t)(counts[i & 1023] * (360.0f * 65536.0f / 4096.0f));
+	double t2 = now_ns();
+	volatile int64_t den = 4096;
+	for (uint32_t i=0; i < n; i++) {
+		sink += (int32_t)(((int64_t)counts[i & 1023] * (360 << 16)) / den);
+	}
+	double t3 = now_ns();
+	printf("per conversion: multiply-shift %.2f ns, float %.2f ns, 64 bit divide %.2f ns\n",
+		(t1 - t0) / n, (t2 - t1) / n, (t3 - t2) / n);
+	printf("%s\n", ok ? "all ok" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/* Encoder Library - EncoderShift decoding against Encoder
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Runs EncoderShift with a simulated chain of 74HC165 chips, and a
+// polled Encoder on 2 simulated lines for every encoder in the chain,
+// given the same pin levels.  Counts must always be equal:
+//
+//   table     all 16 old/new states, on every encoder of 3 words of
+//             the bit-parallel decoder, the last only partly used
+//   random    many scans where any number of encoders change, by 0, 1
+//             or 2 steps, all at once
+//
+// Both with and without ENCODER_FILTER_REJECT.
+//
+//   g++ -O2 -I../.. shift_check.cpp -o shift_check
+//   ./shift_check
+
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <EncoderShift.h>
+#include <stdio.h>
+
+#define ENCODERS 40	// 10 chips, 2.5 words of 16
+
+// the chain: each encoder's pin1 (A) and pin2 (B) levels, wired to H
+// and G of the first chip, then F and E, and so on
+class SimBus
+{
+public:
+	void begin() { }
+	void read(uint8_t *data, uint8_t bytes) {
+		for (uint8_t i=0; i < bytes; i++) {
+			uint8_t b = 0;
+			for (uint8_t k=0; k < 4; k++) {
+				uint8_t n = i * 4 + k;
+				if (n >= ENCODERS) continue;
+				if (pin1[n]) b |= 0x80 >> (k * 2);
+				if (pin2[n]) b |= 0x40 >> (k * 2);
+			}
+			data[i] = b;
+		}
+	}
+	// encoder n to state s, pin1 in bit 0 and pin2 in bit 1 as in Encoder
+	void set(uint8_t n, uint8_t s) {
+		pin1[n] = s & 1;
+		pin2[n] = (s >> 1) & 1;
+		volatile uint8_t *levels = encoder_linux_levels();
+		levels[n * 2] = s & 1;
+		levels[n * 2 + 1] = (s >> 1) & 1;
+	}
+	uint8_t pin1[ENCODERS], pin2[ENCODERS];
+};
+
+struct RejectPolledTraits : EncoderPolledTraits {
+	static const uint8_t filter = ENCODER_FILTER_REJECT;
+};
+struct RejectTraits : EncoderDefaultTraits {
+	static const uint8_t filter = ENCODER_FILTER_REJECT;
+};
+
+static uint32_t rng = 97531;
+static uint32_t random32() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+template <class ShiftTraits, class PolledTraits>
+static int check(const char *name) {
+	SimBus bus;
+	EncoderShift<SimBus, ENCODERS, ShiftTraits> shift(bus);
+	static BasicEncoder<PolledTraits> ref[ENCODERS];
+	uint8_t state[ENCODERS];
+	for (uint8_t n=0; n < ENCODERS; n++) {
+		state[n] = 0;
+		bus.set(n, 0);
+		ref[n].begin(n * 2, n * 2 + 1);
+	}
+	shift.begin();
+	int errors = 0;
+
+	// every encoder gets a different one of the 16 transitions on each
+	// pass, so all 16 are seen in every lane of every word
+	for (uint8_t pass=0; pass < 16; pass++) {
+		for (uint8_t n=0; n < ENCODERS; n++) {
+			uint8_t t = (n + pass) & 15;
+			bus.set(n, t & 3);
+			state[n] = t & 3;
+		}
+		shift.scan();
+		for (uint8_t n=0; n < ENCODERS; n++) {
+			ref[n].read();
+			ref[n].write(0);
+			shift.write(n, 0);
+		}
+		for (uint8_t n=0; n < ENCODERS; n++) {
+			uint8_t t = (n + pass) & 15;
+			bus.set(n, t >> 2);
+			state[n] = t >> 2;
+		}
+		shift.scan();
+		for (uint8_t n=0; n < ENCODERS; n++) {
+			int32_t want = ref[n].read(), got = shift.read(n);
+			if (want != got && errors++ < 5) {
+				uint8_t t = (n + pass) & 15;
+				printf("error: %s, encoder %u, state %u to %u, %d, Encoder %d\n",
+					name, n, t & 3, t >> 2, got, want);
+			}
+		}
+	}
+
+	// random walks, any number changing per scan
+	for (uint32_t step=0; step < 200000; step++) {
+		for (uint8_t n=0; n < ENCODERS; n++) {
+			uint32_t r = random32();
+			if (r & 0x3) continue;		// most encoders stay still
+			// states in order around the cycle, and back (same table)
+			static const uint8_t gray[4] = {0, 1, 3, 2};
+			uint8_t i = gray[state[n]];
+			uint8_t steps = ((r >> 2) % 16 == 0) ? 2 : 1;	// sometimes too fast
+			i = (r & 0x100) ? i + steps : i - steps;
+			state[n] = gray[i & 3];
+			bus.set(n, state[n]);
+		}
+		shift.scan();
+		for (uint8_t n=0; n < ENCODERS; n++) {
+			int32_t want = ref[n].read(), got = shift.read(n);
+			if (want != got && errors++ < 5) {
+				printf("error: %s, encoder %u at step %u, %d, Encoder %d\n",
+					name, n, step, got, want);
+			}
+		}
+	}
+	printf("%-16s %u encoders, %u scans: %s\n", name, ENCODERS, shift.scans,
+		errors ? "FAIL" : "ok");
+	return errors;
+}
+
+int main() {
+	int errors = check<EncoderDefaultTraits, EncoderPolledTraits>("plain");
+	errors += check<RejectTraits, RejectPolledTraits>("filter reject");
+	return errors ? 1 : 0;
+}
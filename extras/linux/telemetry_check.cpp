@@ -0,0 +1,186 @@
+/* Encoder Library - EncoderTelemetry stream decoding
+ * http://www.pjrc.com/teensy/td_libs_Encoder.html
+ *
+ * This example code is in the public domain.
+ */
+
+// Sends random walks of 4 axes through EncoderTelemetry, damages the
+// byte stream, and feeds it to EncoderTelemetryDecoder:
+//
+//   clean     every frame decodes, with the positions sent
+//   crc       1 bit flipped in some frames.  Those are rejected, never
+//             reported, and counted as lost by the next good frame.
+//   garbage   random bytes, many of them 0xA5, between frames.  The
+//             decoder must resync and lose no frames.
+//   lost      whole frames left out.  lostFrames must equal the number
+//             left out, and positions come back at the next key frame.
+//
+// Whenever decode() reports a frame, the positions must be exactly the
+// ones sent in the last good frame received.
+//
+//   g++ -O2 -I../.. telemetry_check.cpp -o telemetry_check
+//   ./telemetry_check
+
+#define ENCODER_SETTLE_MICROSECONDS 0
+#include <EncoderLinuxGpio.h>
+#include <EncoderTelemetry.h>
+#include <stdio.h>
+#include <string.h>
+
+#define AXES	4
+#define FRAMES	20000
+
+// collects what EncoderTelemetry writes
+class Capture : public Print
+{
+public:
+	size_t write(uint8_t b) {
+		if (len < sizeof(data)) data[len++] = b;
+		return 1;
+	}
+	uint8_t data[FRAMES * (AXES * 5 + 6)];
+	uint32_t len;
+};
+
+static Capture sent;
+static uint32_t frame_start[FRAMES + 1];
+static int32_t frame_pos[FRAMES][AXES];
+
+static uint8_t stream[FRAMES * (AXES * 5 + 6 + 40)];
+static uint32_t stream_end[FRAMES];	// index of the last byte, or ~0 if not sent
+static bool expect_valid[FRAMES];
+
+static uint32_t rng = 2468;
+static uint32_t random32() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static int errors = 0;
+
+enum { KEEP, CORRUPT, DROP };
+
+static int keep_all(uint32_t k) { return KEEP; }
+static int corrupt_some(uint32_t k) { return (random32() % 50 == 0) ? CORRUPT : KEEP; }
+static int drop_some(uint32_t k) { return (random32() % 40 == 0) ? DROP : KEEP; }
+
+// Build a stream from the sent frames, decode it and check the result.
+// damage() chooses what happens to each frame, garbage adds random bytes
+// before it.
+static void run(const char *name, int (*damage)(uint32_t), bool garbage) {
+	uint32_t len = 0, kept = 0, missing = 0, missing_before_last = 0;
+	bool prev_valid = false;
+	for (uint32_t k=0; k < FRAMES; k++) {
+		if (garbage && (random32() & 3) == 0) {
+			uint32_t n = random32() % 40;
+			for (uint32_t i=0; i < n; i++) {
+				uint32_t r = random32();
+				stream[len++] = (r & 0x300) ? (uint8_t)r : ENCODER_TELEMETRY_SYNC;
+			}
+		}
+		int what = (k == 0 || k == FRAMES - 1) ? KEEP : damage(k);
+		uint32_t size = frame_start[k + 1] - frame_start[k];
+		if (what == DROP) {
+			stream_end[k] = ~0u;
+		} else {
+			memcpy(stream + len, sent.data + frame_start[k], size);
+			if (what == CORRUPT) {
+				uint32_t bit = random32() % (size * 8);
+				stream[len + bit / 8] ^= 1 << (bit % 8);
+			}
+			len += size;
+			stream_end[k] = (what == KEEP) ? len - 1 : ~0u;
+		}
+		if (what == KEEP) {
+			kept++;
+			missing_before_last = missing;
+		} else {
+			missing++;
+		}
+		// deltas need the frame before, or a key frame
+		bool key = sent.data[frame_start[k] + 2] & ENCODER_TELEMETRY_KEY;
+		expect_valid[k] = (what == KEEP) && (key || prev_valid);
+		prev_valid = expect_valid[k];
+	}
+
+	EncoderTelemetryDecoder decoder;
+	uint32_t reports = 0, last = 0;
+	int err = 0;
+	for (uint32_t i=0; i < len; i++) {
+		if (!decoder.decode(stream[i])) continue;
+		reports++;
+		// the latest frame received with this sequence number
+		while (last + 1 < FRAMES && (stream_end[last + 1] <= i || stream_end[last + 1] == ~0u)) last++;
+		uint32_t k = last;
+		while (stream_end[k] == ~0u || (k & 255) != decoder.sequence()) {
+			if (k == 0) break;
+			k--;
+		}
+		bool ok = stream_end[k] != ~0u && stream_end[k] <= i && expect_valid[k]
+			&& decoder.axes() == AXES;
+		for (int a=0; ok && a < AXES; a++) {
+			if (decoder.position(a) != frame_pos[k][a]) ok = false;
+		}
+		if (!ok && err++ < 5) {
+			printf("error: %s, frame %u reported at byte %u, seq %u, pos %d, expected %d\n",
+				name, k, i, decoder.sequence(), decoder.position(0), frame_pos[k][0]);
+		}
+	}
+	uint32_t valid = 0;
+	for (uint32_t k=0; k < FRAMES; k++) valid += expect_valid[k];
+	if (decoder.frames != kept) {
+		if (err++ < 5) printf("error: %s, %u good frames, expected %u\n", name, decoder.frames, kept);
+	}
+	if (decoder.lostFrames != missing_before_last) {
+		if (err++ < 5) printf("error: %s, %u lost frames, expected %u\n",
+			name, decoder.lostFrames, missing_before_last);
+	}
+	// without garbage, every valid frame is reported at its last byte
+	if (!garbage && reports != valid) {
+		if (err++ < 5) printf("error: %s, %u frames reported, expected %u\n", name, reports, valid);
+	}
+	if (damage == keep_all && !garbage && decoder.crcErrors != 0) {
+		if (err++ < 5) printf("error: %s, %u crc errors\n", name, decoder.crcErrors);
+	}
+	printf("%-8s %7u bytes, %5u frames, %5u reported, %4u crc errors, %4u lost: %s\n",
+		name, len, decoder.frames, reports, decoder.crcErrors, decoder.lostFrames,
+		err ? "FAIL" : "ok");
+	errors += err;
+}
+
+int main() {
+	BasicEncoderTelemetry<Encoder> telemetry(sent);
+	telemetry.setKeyInterval(16);
+	int32_t pos[ENCODER_TELEMETRY_AXES + 1];
+	memset(pos, 0, sizeof(pos));
+
+	// more axes than ENCODER_TELEMETRY_AXES are refused, sending nothing
+	if (telemetry.send(pos, ENCODER_TELEMETRY_AXES + 1) != 0 || sent.len != 0) {
+		printf("error: send() with too many axes\n");
+		errors++;
+	}
+
+	for (uint32_t k=0; k < FRAMES; k++) {
+		for (int a=0; a < AXES; a++) {
+			uint32_t r = random32();
+			if ((r & 0xFF) == 0) {
+				pos[a] = (int32_t)random32();	// a big jump, 5 byte varint
+			} else {
+				pos[a] += (int32_t)((r >> 8) % 201) - 100;
+			}
+			frame_pos[k][a] = pos[a];
+		}
+		frame_start[k] = sent.len;
+		telemetry.send(pos, AXES);
+	}
+	frame_start[FRAMES] = sent.len;
+
+	run("clean", keep_all, false);
+	run("crc", corrupt_some, false);
+	run("garbage", keep_all, true);
+	run("lost", drop_some, false);
+	printf("%s\n", errors ? "FAIL" : "ok");
+	return errors ? 1 : 0;
+}
@@ -129,6 +129,13 @@ IO_REG_TYPE directRead(volatile IO_REG_TYPE *base, IO_REG_TYPE pin)
     #define DIRECT_PIN_READ(base, pin) digitalRead(pin)
     
 
+#elif defined(ENCODER_LINUX_GPIO)
+
+#define IO_REG_TYPE			uint8_t
+#define PIN_TO_BASEREG(pin)             (encoder_linux_levels() + (pin))
+#define PIN_TO_BITMASK(pin)             (1)
+#define DIRECT_PIN_READ(base, mask)     (((*(base)) & (mask)) ? 1 : 0)
+
 #endif
 
 #endif
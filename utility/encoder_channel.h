@@ -0,0 +1,24 @@
+// One channel of a multi-encoder source as an Encoder-like object
+
+#ifndef encoder_channel_h_
+#define encoder_channel_h_
+
+// Sources which count many encoders (EncoderShift, EncoderLS7366) have
+// read(n), write(n, p) and readAndReset(n).  EncoderChannel wraps one
+// of them with the usual Encoder methods, so it works with code written
+// for Encoder.  There is no movement(), so not with EncoderCursor.
+template <class Source>
+class EncoderChannel
+{
+public:
+	typedef typename Source::count_t count_t;
+	EncoderChannel(Source &s, uint8_t n) : source(s), index(n) { }
+	inline count_t read() { return source.read(index); }
+	inline count_t readAndReset() { return source.readAndReset(index); }
+	inline void write(count_t p) { source.write(index, p); }
+private:
+	Source &source;
+	uint8_t index;
+};
+
+#endif
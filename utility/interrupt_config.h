@@ -72,6 +72,158 @@ static void enableInterrupt(uint8_t num)
 	}
 }
 
+#elif defined(TEENSYDUINO) && (defined(KINETISK) || defined(KINETISL) \
+  || defined(__IMXRT1052__) || defined(__IMXRT1062__))
+
+// On ARM, Encoder takes over the whole port interrupt, rather than going
+// through attachInterrupt's dispatcher.  The handler reads the port's
+// interrupt flags once, clears them, and runs update() only for encoders
+// with a pin on that port which changed.  Like AVR, this conflicts with
+// any other use of attachInterrupt() on the same port(s).
+//
+// EncoderDispatch's attach_interrupt() passes the interruptArgs entry
+// it just filled in, so the port code knows which encoder to update.
+#define attachInterrupt(num, func, mode) \
+	EncoderPorts<State, Decoder>::attach(num, interruptArgs[num])
+
+// Encoders (really, pin masks) per port.  A port with more encoders than
+// this will not count the extras, so increase it if needed.
+#ifndef ENCODER_PORT_SLOTS
+#define ENCODER_PORT_SLOTS 16
+#endif
+
+// The list of encoders with pins on one port.  Everything hardware
+// specific is outside this struct, so it can be tested with simulated
+// flag values.
+template <class State>
+struct EncoderPortSlots {
+	uint32_t mask[ENCODER_PORT_SLOTS];	// pins of each encoder on this port
+	State *  state[ENCODER_PORT_SLOTS];
+	uint8_t  count;
+	// must be called with interrupts disabled
+	bool add(uint32_t bitmask, State *s) {
+		for (uint8_t i=0; i < count; i++) {
+			if (state[i] == s) {
+				mask[i] |= bitmask;	// 2nd pin of same encoder
+				return true;
+			}
+		}
+		if (count >= ENCODER_PORT_SLOTS) return false;
+		mask[count] = bitmask;
+		state[count] = s;
+		count++;
+		return true;
+	}
+	// update each encoder once, even if both its pins changed
+	template <class Decoder>
+	inline void dispatch(uint32_t flags) const {
+		for (uint8_t i=0; i < count; i++) {
+			if (flags & mask[i]) Decoder::update(state[i]);
+		}
+	}
+};
+
+#if defined(KINETISK) || defined(KINETISL)
+
+// Teensy 3.x & LC: PORTA - PORTE, each with its own ISFR register.
+// On Teensy LC only A, C & D have interrupts, and C & D share one.
+template <class State, class Decoder>
+class EncoderPorts
+{
+public:
+	static void attach(uint8_t pin, State *state) {
+		volatile uint32_t *config = portConfigRegister(pin);
+		uint32_t offset = (volatile uint8_t *)config
+			- (volatile uint8_t *)&PORTA_PCR0;
+		uint8_t port = offset >> 12;		// 4K per port
+		uint32_t bitmask = 1 << ((offset & 0xFFF) >> 2);
+		__disable_irq();
+		ports[port].add(bitmask, state);
+		// same as attachInterrupt(CHANGE): clear ISF, IRQC = 1011
+		*config = (*config & ~0x000F0000) | 0x010B0000;
+		__enable_irq();
+		switch (port) {
+		#if defined(KINETISK)
+		  case 0: attachInterruptVector(IRQ_PORTA, isr_a); NVIC_ENABLE_IRQ(IRQ_PORTA); break;
+		  case 1: attachInterruptVector(IRQ_PORTB, isr_b); NVIC_ENABLE_IRQ(IRQ_PORTB); break;
+		  case 2: attachInterruptVector(IRQ_PORTC, isr_c); NVIC_ENABLE_IRQ(IRQ_PORTC); break;
+		  case 3: attachInterruptVector(IRQ_PORTD, isr_d); NVIC_ENABLE_IRQ(IRQ_PORTD); break;
+		  case 4: attachInterruptVector(IRQ_PORTE, isr_e); NVIC_ENABLE_IRQ(IRQ_PORTE); break;
+		#else
+		  case 0: attachInterruptVector(IRQ_PORTA, isr_a); NVIC_ENABLE_IRQ(IRQ_PORTA); break;
+		  case 2:
+		  case 3: attachInterruptVector(IRQ_PORTCD, isr_cd); NVIC_ENABLE_IRQ(IRQ_PORTCD); break;
+		#endif
+		}
+	}
+	static EncoderPortSlots<State> ports[5];
+private:
+	// Reg is volatile uint32_t, or a simulated write 1 to clear
+	// register in extras/linux/port_isr_sim.cpp
+	template <class Reg>
+	static inline void service(Reg &isfr, uint8_t port) {
+		uint32_t flags = isfr;	// read flags once
+		isfr = flags;		// clear them before reading pins
+		ports[port].template dispatch<Decoder>(flags);
+	}
+	static void isr_a(void) { service(PORTA_ISFR, 0); }
+	#if defined(KINETISK)
+	static void isr_b(void) { service(PORTB_ISFR, 1); }
+	static void isr_c(void) { service(PORTC_ISFR, 2); }
+	static void isr_d(void) { service(PORTD_ISFR, 3); }
+	static void isr_e(void) { service(PORTE_ISFR, 4); }
+	#else
+	static void isr_cd(void) { service(PORTC_ISFR, 2); service(PORTD_ISFR, 3); }
+	#endif
+};
+
+#else
+
+// Teensy 4.x: fast GPIO6 - GPIO9 all share IRQ_GPIO6789.  Registers are
+// indexed as 32 bit words from each port's DR register.
+template <class State, class Decoder>
+class EncoderPorts
+{
+public:
+	static void attach(uint8_t pin, State *state) {
+		volatile uint32_t *gpio = portOutputRegister(pin);
+		uint32_t bitmask = digitalPinToBitMask(pin);
+		uint8_t port = ((uintptr_t)gpio - (uintptr_t)&GPIO6_DR) >> 14;	// 16K apart
+		__disable_irq();
+		ports[port].add(bitmask, state);
+		gpio[5] &= ~bitmask;	// IMR
+		gpio[7] |= bitmask;	// EDGE_SEL, both edges
+		gpio[6] = bitmask;	// ISR, clear any old flag
+		gpio[5] |= bitmask;	// IMR
+		__enable_irq();
+		attachInterruptVector(IRQ_GPIO6789, isr);
+		NVIC_ENABLE_IRQ(IRQ_GPIO6789);
+	}
+	static EncoderPortSlots<State> ports[4];
+private:
+	static inline void service(volatile uint32_t *gpio, uint8_t port) {
+		uint32_t flags = gpio[6] & gpio[5];	// ISR & IMR, read once
+		if (flags) {
+			gpio[6] = flags;
+			ports[port].template dispatch<Decoder>(flags);
+		}
+	}
+	static void isr(void) {
+		service(&GPIO6_DR, 0);
+		service(&GPIO7_DR, 1);
+		service(&GPIO8_DR, 2);
+		service(&GPIO9_DR, 3);
+		#if defined(__arm__)
+		asm volatile ("dsb");	// flags must be clear before return
+		#endif
+	}
+};
+
+#endif
+
+template <class State, class Decoder>
+EncoderPortSlots<State> EncoderPorts<State, Decoder>::ports[];
+
 #elif defined(__PIC32MX__)
 
 #ifdef ENCODER_OPTIMIZE_INTERRUPTS
@@ -80,6 +232,9 @@ static void enableInterrupt(uint8_t num)
 
 #else
 
+// SAMD and ESP32 are not supported, because their cores own the GPIO
+// interrupt (SAMD's EIC_Handler is linked from WInterrupts.c, ESP32
+// uses the ESP-IDF gpio isr service), so the library can not take it.
 #ifdef ENCODER_OPTIMIZE_INTERRUPTS
 #undef ENCODER_OPTIMIZE_INTERRUPTS
 #endif
@@ -0,0 +1,906 @@
+// Interrupt dispatch for Encoder and other decoders using its update() pattern
+
+#ifndef interrupt_dispatch_h_
+#define interrupt_dispatch_h_
+
+// Each decoder class (BasicEncoder and friends) inherits one of these, so
+// every decoder type gets its own interruptArgs table and isrN routines
+// which call that decoder's static update() directly.  State is the
+// struct the interrupt routine works on, Decoder provides
+// static void update(State *).
+//
+// Keeping the call direct, with no function pointer in the interrupt,
+// means tables are not shared: each BasicEncoder traits type (and each
+// other decoder class) costs CORE_NUM_INTERRUPT pointers of RAM plus
+// one isrN routine per interrupt pin, whether it has 1 encoder or 10.
+// ENCODER_INTERRUPT_SLOTS makes that ENCODER_INTERRUPT_SLOTS of each,
+// plus a byte per slot: 216 bytes down to 31 on Arduino Due with 6
+// slots, but 4 up to 19 on Uno.  examples/Footprint lists more boards.
+template <class State, class Decoder>
+class EncoderDispatch
+{
+public:
+	static State * interruptArgs[ENCODER_ARGLIST_SIZE];
+protected:
+#if defined(ENCODER_USE_INTERRUPTS) && !defined(ENCODER_LINUX_GPIO)
+	// interrupt number for a pin, or 255 if it has none
+	static uint8_t pin_to_interrupt(uint8_t pin) {
+		switch (pin) {
+		#ifdef CORE_INT0_PIN
+			case CORE_INT0_PIN: return 0;
+		#endif
+		#ifdef CORE_INT1_PIN
+			case CORE_INT1_PIN: return 1;
+		#endif
+		#ifdef CORE_INT2_PIN
+			case CORE_INT2_PIN: return 2;
+		#endif
+		#ifdef CORE_INT3_PIN
+			case CORE_INT3_PIN: return 3;
+		#endif
+		#ifdef CORE_INT4_PIN
+			case CORE_INT4_PIN: return 4;
+		#endif
+		#ifdef CORE_INT5_PIN
+			case CORE_INT5_PIN: return 5;
+		#endif
+		#ifdef CORE_INT6_PIN
+			case CORE_INT6_PIN: return 6;
+		#endif
+		#ifdef CORE_INT7_PIN
+			case CORE_INT7_PIN: return 7;
+		#endif
+		#ifdef CORE_INT8_PIN
+			case CORE_INT8_PIN: return 8;
+		#endif
+		#ifdef CORE_INT9_PIN
+			case CORE_INT9_PIN: return 9;
+		#endif
+		#ifdef CORE_INT10_PIN
+			case CORE_INT10_PIN: return 10;
+		#endif
+		#ifdef CORE_INT11_PIN
+			case CORE_INT11_PIN: return 11;
+		#endif
+		#ifdef CORE_INT12_PIN
+			case CORE_INT12_PIN: return 12;
+		#endif
+		#ifdef CORE_INT13_PIN
+			case CORE_INT13_PIN: return 13;
+		#endif
+		#ifdef CORE_INT14_PIN
+			case CORE_INT14_PIN: return 14;
+		#endif
+		#ifdef CORE_INT15_PIN
+			case CORE_INT15_PIN: return 15;
+		#endif
+		#ifdef CORE_INT16_PIN
+			case CORE_INT16_PIN: return 16;
+		#endif
+		#ifdef CORE_INT17_PIN
+			case CORE_INT17_PIN: return 17;
+		#endif
+		#ifdef CORE_INT18_PIN
+			case CORE_INT18_PIN: return 18;
+		#endif
+		#ifdef CORE_INT19_PIN
+			case CORE_INT19_PIN: return 19;
+		#endif
+		#ifdef CORE_INT20_PIN
+			case CORE_INT20_PIN: return 20;
+		#endif
+		#ifdef CORE_INT21_PIN
+			case CORE_INT21_PIN: return 21;
+		#endif
+		#ifdef CORE_INT22_PIN
+			case CORE_INT22_PIN: return 22;
+		#endif
+		#ifdef CORE_INT23_PIN
+			case CORE_INT23_PIN: return 23;
+		#endif
+		#ifdef CORE_INT24_PIN
+			case CORE_INT24_PIN: return 24;
+		#endif
+		#ifdef CORE_INT25_PIN
+			case CORE_INT25_PIN: return 25;
+		#endif
+		#ifdef CORE_INT26_PIN
+			case CORE_INT26_PIN: return 26;
+		#endif
+		#ifdef CORE_INT27_PIN
+			case CORE_INT27_PIN: return 27;
+		#endif
+		#ifdef CORE_INT28_PIN
+			case CORE_INT28_PIN: return 28;
+		#endif
+		#ifdef CORE_INT29_PIN
+			case CORE_INT29_PIN: return 29;
+		#endif
+		#ifdef CORE_INT30_PIN
+			case CORE_INT30_PIN: return 30;
+		#endif
+		#ifdef CORE_INT31_PIN
+			case CORE_INT31_PIN: return 31;
+		#endif
+		#ifdef CORE_INT32_PIN
+			case CORE_INT32_PIN: return 32;
+		#endif
+		#ifdef CORE_INT33_PIN
+			case CORE_INT33_PIN: return 33;
+		#endif
+		#ifdef CORE_INT34_PIN
+			case CORE_INT34_PIN: return 34;
+		#endif
+		#ifdef CORE_INT35_PIN
+			case CORE_INT35_PIN: return 35;
+		#endif
+		#ifdef CORE_INT36_PIN
+			case CORE_INT36_PIN: return 36;
+		#endif
+		#ifdef CORE_INT37_PIN
+			case CORE_INT37_PIN: return 37;
+		#endif
+		#ifdef CORE_INT38_PIN
+			case CORE_INT38_PIN: return 38;
+		#endif
+		#ifdef CORE_INT39_PIN
+			case CORE_INT39_PIN: return 39;
+		#endif
+		#ifdef CORE_INT40_PIN
+			case CORE_INT40_PIN: return 40;
+		#endif
+		#ifdef CORE_INT41_PIN
+			case CORE_INT41_PIN: return 41;
+		#endif
+		#ifdef CORE_INT42_PIN
+			case CORE_INT42_PIN: return 42;
+		#endif
+		#ifdef CORE_INT43_PIN
+			case CORE_INT43_PIN: return 43;
+		#endif
+		#ifdef CORE_INT44_PIN
+			case CORE_INT44_PIN: return 44;
+		#endif
+		#ifdef CORE_INT45_PIN
+			case CORE_INT45_PIN: return 45;
+		#endif
+		#ifdef CORE_INT46_PIN
+			case CORE_INT46_PIN: return 46;
+		#endif
+		#ifdef CORE_INT47_PIN
+			case CORE_INT47_PIN: return 47;
+		#endif
+		#ifdef CORE_INT48_PIN
+			case CORE_INT48_PIN: return 48;
+		#endif
+		#ifdef CORE_INT49_PIN
+			case CORE_INT49_PIN: return 49;
+		#endif
+		#ifdef CORE_INT50_PIN
+			case CORE_INT50_PIN: return 50;
+		#endif
+		#ifdef CORE_INT51_PIN
+			case CORE_INT51_PIN: return 51;
+		#endif
+		#ifdef CORE_INT52_PIN
+			case CORE_INT52_PIN: return 52;
+		#endif
+		#ifdef CORE_INT53_PIN
+			case CORE_INT53_PIN: return 53;
+		#endif
+		#ifdef CORE_INT54_PIN
+			case CORE_INT54_PIN: return 54;
+		#endif
+		#ifdef CORE_INT55_PIN
+			case CORE_INT55_PIN: return 55;
+		#endif
+		#ifdef CORE_INT56_PIN
+			case CORE_INT56_PIN: return 56;
+		#endif
+		#ifdef CORE_INT57_PIN
+			case CORE_INT57_PIN: return 57;
+		#endif
+		#ifdef CORE_INT58_PIN
+			case CORE_INT58_PIN: return 58;
+		#endif
+		#ifdef CORE_INT59_PIN
+			case CORE_INT59_PIN: return 59;
+		#endif
+		}
+		return 255;
+	}
+#endif
+#if defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_LINUX_GPIO)
+	// Linux passes the line number to the handler, so 1 routine is
+	// enough for every line
+	static uint8_t attach_interrupt(uint8_t pin, State *state) {
+		interruptArgs[pin] = state;
+		encoder_linux_vectors()[pin] = isr_line;
+		return 1;
+	}
+	static void isr_line(uint8_t line) { Decoder::update(interruptArgs[line]); }
+#elif defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_ATTACH_ARG)
+	// The core keeps the argument for each pin, so there is nothing to
+	// look up.  isr_arg() only restores the type, update() is inlined.
+	static uint8_t attach_interrupt(uint8_t pin, State *state) {
+		if (pin_to_interrupt(pin) == 255) return 0;
+		attachInterruptArg(pin, isr_arg, state, CHANGE);
+		return 1;
+	}
+	static ENCODER_ISR_ATTR void isr_arg(void *arg) { Decoder::update((State *)arg); }
+#elif defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_INTERRUPT_SLOTS)
+	// Compact tables: slot k has interruptArgs[k] and slot_isr<k>, and
+	// interruptNumbers[k] maps it back to the interrupt it serves, so
+	// begin() again on the same pin reuses its slot.  detach_interrupt()
+	// frees the slot (interrupt number 255) for any pin.  Pins beyond
+	// the last slot get no interrupt, and read() polls them instead.
+	static_assert(ENCODER_INTERRUPT_SLOTS > 0 && ENCODER_INTERRUPT_SLOTS <= 16,
+		"ENCODER_INTERRUPT_SLOTS must be 1 to 16");
+	static uint8_t attach_interrupt(uint8_t pin, State *state) {
+		uint8_t irq = pin_to_interrupt(pin);
+		if (irq == 255) return 0;
+		uint8_t slot = find_slot(irq);
+		if (slot == 255) slot = find_slot(255);
+		if (slot == 255) {
+			if (slotsUsed >= ENCODER_INTERRUPT_SLOTS) return 0;
+			slot = slotsUsed++;
+		}
+		interruptArgs[slot] = state;
+		interruptNumbers[slot] = irq;
+		switch (slot) {
+		#if ENCODER_INTERRUPT_SLOTS > 0
+			case 0: attachInterrupt(irq, slot_isr<0>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 1
+			case 1: attachInterrupt(irq, slot_isr<1>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 2
+			case 2: attachInterrupt(irq, slot_isr<2>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 3
+			case 3: attachInterrupt(irq, slot_isr<3>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 4
+			case 4: attachInterrupt(irq, slot_isr<4>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 5
+			case 5: attachInterrupt(irq, slot_isr<5>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 6
+			case 6: attachInterrupt(irq, slot_isr<6>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 7
+			case 7: attachInterrupt(irq, slot_isr<7>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 8
+			case 8: attachInterrupt(irq, slot_isr<8>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 9
+			case 9: attachInterrupt(irq, slot_isr<9>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 10
+			case 10: attachInterrupt(irq, slot_isr<10>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 11
+			case 11: attachInterrupt(irq, slot_isr<11>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 12
+			case 12: attachInterrupt(irq, slot_isr<12>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 13
+			case 13: attachInterrupt(irq, slot_isr<13>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 14
+			case 14: attachInterrupt(irq, slot_isr<14>, CHANGE); break;
+		#endif
+		#if ENCODER_INTERRUPT_SLOTS > 15
+			case 15: attachInterrupt(irq, slot_isr<15>, CHANGE); break;
+		#endif
+		}
+		return 1;
+	}
+	template <uint8_t slot>
+	static ENCODER_ISR_ATTR void slot_isr(void) { Decoder::update(interruptArgs[slot]); }
+	static uint8_t find_slot(uint8_t irq) {
+		for (uint8_t slot=0; slot < slotsUsed; slot++) {
+			if (interruptNumbers[slot] == irq) return slot;
+		}
+		return 255;
+	}
+	static uint8_t interruptNumbers[ENCODER_INTERRUPT_SLOTS];
+	static uint8_t slotsUsed;
+#elif defined(ENCODER_USE_INTERRUPTS)
+	// this giant function is an unfortunate consequence of Arduino's
+	// attachInterrupt function not supporting any way to pass a pointer
+	// or other context to the attached function.
+	static uint8_t attach_interrupt(uint8_t pin, State *state) {
+		switch (pin) {
+		#ifdef CORE_INT0_PIN
+			case CORE_INT0_PIN:
+				interruptArgs[0] = state;
+				attachInterrupt(0, isr0, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT1_PIN
+			case CORE_INT1_PIN:
+				interruptArgs[1] = state;
+				attachInterrupt(1, isr1, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT2_PIN
+			case CORE_INT2_PIN:
+				interruptArgs[2] = state;
+				attachInterrupt(2, isr2, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT3_PIN
+			case CORE_INT3_PIN:
+				interruptArgs[3] = state;
+				attachInterrupt(3, isr3, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT4_PIN
+			case CORE_INT4_PIN:
+				interruptArgs[4] = state;
+				attachInterrupt(4, isr4, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT5_PIN
+			case CORE_INT5_PIN:
+				interruptArgs[5] = state;
+				attachInterrupt(5, isr5, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT6_PIN
+			case CORE_INT6_PIN:
+				interruptArgs[6] = state;
+				attachInterrupt(6, isr6, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT7_PIN
+			case CORE_INT7_PIN:
+				interruptArgs[7] = state;
+				attachInterrupt(7, isr7, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT8_PIN
+			case CORE_INT8_PIN:
+				interruptArgs[8] = state;
+				attachInterrupt(8, isr8, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT9_PIN
+			case CORE_INT9_PIN:
+				interruptArgs[9] = state;
+				attachInterrupt(9, isr9, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT10_PIN
+			case CORE_INT10_PIN:
+				interruptArgs[10] = state;
+				attachInterrupt(10, isr10, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT11_PIN
+			case CORE_INT11_PIN:
+				interruptArgs[11] = state;
+				attachInterrupt(11, isr11, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT12_PIN
+			case CORE_INT12_PIN:
+				interruptArgs[12] = state;
+				attachInterrupt(12, isr12, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT13_PIN
+			case CORE_INT13_PIN:
+				interruptArgs[13] = state;
+				attachInterrupt(13, isr13, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT14_PIN
+			case CORE_INT14_PIN:
+				interruptArgs[14] = state;
+				attachInterrupt(14, isr14, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT15_PIN
+			case CORE_INT15_PIN:
+				interruptArgs[15] = state;
+				attachInterrupt(15, isr15, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT16_PIN
+			case CORE_INT16_PIN:
+				interruptArgs[16] = state;
+				attachInterrupt(16, isr16, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT17_PIN
+			case CORE_INT17_PIN:
+				interruptArgs[17] = state;
+				attachInterrupt(17, isr17, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT18_PIN
+			case CORE_INT18_PIN:
+				interruptArgs[18] = state;
+				attachInterrupt(18, isr18, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT19_PIN
+			case CORE_INT19_PIN:
+				interruptArgs[19] = state;
+				attachInterrupt(19, isr19, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT20_PIN
+			case CORE_INT20_PIN:
+				interruptArgs[20] = state;
+				attachInterrupt(20, isr20, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT21_PIN
+			case CORE_INT21_PIN:
+				interruptArgs[21] = state;
+				attachInterrupt(21, isr21, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT22_PIN
+			case CORE_INT22_PIN:
+				interruptArgs[22] = state;
+				attachInterrupt(22, isr22, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT23_PIN
+			case CORE_INT23_PIN:
+				interruptArgs[23] = state;
+				attachInterrupt(23, isr23, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT24_PIN
+			case CORE_INT24_PIN:
+				interruptArgs[24] = state;
+				attachInterrupt(24, isr24, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT25_PIN
+			case CORE_INT25_PIN:
+				interruptArgs[25] = state;
+				attachInterrupt(25, isr25, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT26_PIN
+			case CORE_INT26_PIN:
+				interruptArgs[26] = state;
+				attachInterrupt(26, isr26, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT27_PIN
+			case CORE_INT27_PIN:
+				interruptArgs[27] = state;
+				attachInterrupt(27, isr27, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT28_PIN
+			case CORE_INT28_PIN:
+				interruptArgs[28] = state;
+				attachInterrupt(28, isr28, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT29_PIN
+			case CORE_INT29_PIN:
+				interruptArgs[29] = state;
+				attachInterrupt(29, isr29, CHANGE);
+				break;
+		#endif
+
+		#ifdef CORE_INT30_PIN
+			case CORE_INT30_PIN:
+				interruptArgs[30] = state;
+				attachInterrupt(30, isr30, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT31_PIN
+			case CORE_INT31_PIN:
+				interruptArgs[31] = state;
+				attachInterrupt(31, isr31, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT32_PIN
+			case CORE_INT32_PIN:
+				interruptArgs[32] = state;
+				attachInterrupt(32, isr32, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT33_PIN
+			case CORE_INT33_PIN:
+				interruptArgs[33] = state;
+				attachInterrupt(33, isr33, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT34_PIN
+			case CORE_INT34_PIN:
+				interruptArgs[34] = state;
+				attachInterrupt(34, isr34, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT35_PIN
+			case CORE_INT35_PIN:
+				interruptArgs[35] = state;
+				attachInterrupt(35, isr35, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT36_PIN
+			case CORE_INT36_PIN:
+				interruptArgs[36] = state;
+				attachInterrupt(36, isr36, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT37_PIN
+			case CORE_INT37_PIN:
+				interruptArgs[37] = state;
+				attachInterrupt(37, isr37, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT38_PIN
+			case CORE_INT38_PIN:
+				interruptArgs[38] = state;
+				attachInterrupt(38, isr38, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT39_PIN
+			case CORE_INT39_PIN:
+				interruptArgs[39] = state;
+				attachInterrupt(39, isr39, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT40_PIN
+			case CORE_INT40_PIN:
+				interruptArgs[40] = state;
+				attachInterrupt(40, isr40, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT41_PIN
+			case CORE_INT41_PIN:
+				interruptArgs[41] = state;
+				attachInterrupt(41, isr41, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT42_PIN
+			case CORE_INT42_PIN:
+				interruptArgs[42] = state;
+				attachInterrupt(42, isr42, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT43_PIN
+			case CORE_INT43_PIN:
+				interruptArgs[43] = state;
+				attachInterrupt(43, isr43, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT44_PIN
+			case CORE_INT44_PIN:
+				interruptArgs[44] = state;
+				attachInterrupt(44, isr44, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT45_PIN
+			case CORE_INT45_PIN:
+				interruptArgs[45] = state;
+				attachInterrupt(45, isr45, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT46_PIN
+			case CORE_INT46_PIN:
+				interruptArgs[46] = state;
+				attachInterrupt(46, isr46, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT47_PIN
+			case CORE_INT47_PIN:
+				interruptArgs[47] = state;
+				attachInterrupt(47, isr47, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT48_PIN
+			case CORE_INT48_PIN:
+				interruptArgs[48] = state;
+				attachInterrupt(48, isr48, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT49_PIN
+			case CORE_INT49_PIN:
+				interruptArgs[49] = state;
+				attachInterrupt(49, isr49, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT50_PIN
+			case CORE_INT50_PIN:
+				interruptArgs[50] = state;
+				attachInterrupt(50, isr50, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT51_PIN
+			case CORE_INT51_PIN:
+				interruptArgs[51] = state;
+				attachInterrupt(51, isr51, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT52_PIN
+			case CORE_INT52_PIN:
+				interruptArgs[52] = state;
+				attachInterrupt(52, isr52, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT53_PIN
+			case CORE_INT53_PIN:
+				interruptArgs[53] = state;
+				attachInterrupt(53, isr53, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT54_PIN
+			case CORE_INT54_PIN:
+				interruptArgs[54] = state;
+				attachInterrupt(54, isr54, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT55_PIN
+			case CORE_INT55_PIN:
+				interruptArgs[55] = state;
+				attachInterrupt(55, isr55, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT56_PIN
+			case CORE_INT56_PIN:
+				interruptArgs[56] = state;
+				attachInterrupt(56, isr56, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT57_PIN
+			case CORE_INT57_PIN:
+				interruptArgs[57] = state;
+				attachInterrupt(57, isr57, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT58_PIN
+			case CORE_INT58_PIN:
+				interruptArgs[58] = state;
+				attachInterrupt(58, isr58, CHANGE);
+				break;
+		#endif
+		#ifdef CORE_INT59_PIN
+			case CORE_INT59_PIN:
+				interruptArgs[59] = state;
+				attachInterrupt(59, isr59, CHANGE);
+				break;
+		#endif
+			default:
+				return 0;
+		}
+		return 1;
+	}
+#else
+	static uint8_t attach_interrupt(uint8_t pin, State *state) { return 0; }
+#endif // ENCODER_USE_INTERRUPTS
+	// Stop a pin's interrupt, so it is only updated by polling.  Nothing
+	// to stop with ENCODER_OPTIMIZE_INTERRUPTS, which owns the vectors.
+#if defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_LINUX_GPIO)
+	static void detach_interrupt(uint8_t pin) { encoder_linux_vectors()[pin] = 0; }
+#elif defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_INTERRUPT_SLOTS)
+	static void detach_interrupt(uint8_t pin) {
+		uint8_t irq = pin_to_interrupt(pin);
+		if (irq == 255) return;
+		uint8_t slot = find_slot(irq);
+		if (slot == 255) return;
+		detachInterrupt(irq);
+		interruptNumbers[slot] = 255;
+		interruptArgs[slot] = 0;
+	}
+#elif defined(ENCODER_USE_INTERRUPTS) && !defined(ENCODER_OPTIMIZE_INTERRUPTS)
+	static void detach_interrupt(uint8_t pin) {
+		uint8_t irq = pin_to_interrupt(pin);
+		if (irq != 255) detachInterrupt(irq);
+	}
+#else
+	static void detach_interrupt(uint8_t pin) { }
+#endif
+
+
+#if defined(ENCODER_USE_INTERRUPTS) && !defined(ENCODER_OPTIMIZE_INTERRUPTS) \
+  && !defined(ENCODER_INTERRUPT_SLOTS) && !defined(ENCODER_ATTACH_ARG)
+	#ifdef CORE_INT0_PIN
+	static ENCODER_ISR_ATTR void isr0(void) { Decoder::update(interruptArgs[0]); }
+	#endif
+	#ifdef CORE_INT1_PIN
+	static ENCODER_ISR_ATTR void isr1(void) { Decoder::update(interruptArgs[1]); }
+	#endif
+	#ifdef CORE_INT2_PIN
+	static ENCODER_ISR_ATTR void isr2(void) { Decoder::update(interruptArgs[2]); }
+	#endif
+	#ifdef CORE_INT3_PIN
+	static ENCODER_ISR_ATTR void isr3(void) { Decoder::update(interruptArgs[3]);}
+	#endif
+	#ifdef CORE_INT4_PIN
+	static ENCODER_ISR_ATTR void isr4(void) { Decoder::update(interruptArgs[4]); }
+	#endif
+	#ifdef CORE_INT5_PIN
+	static ENCODER_ISR_ATTR void isr5(void) { Decoder::update(interruptArgs[5]); }
+	#endif
+	#ifdef CORE_INT6_PIN
+	static ENCODER_ISR_ATTR void isr6(void) { Decoder::update(interruptArgs[6]); }
+	#endif
+	#ifdef CORE_INT7_PIN
+	static ENCODER_ISR_ATTR void isr7(void) { Decoder::update(interruptArgs[7]); }
+	#endif
+	#ifdef CORE_INT8_PIN
+	static ENCODER_ISR_ATTR void isr8(void) { Decoder::update(interruptArgs[8]); }
+	#endif
+	#ifdef CORE_INT9_PIN
+	static ENCODER_ISR_ATTR void isr9(void) { Decoder::update(interruptArgs[9]); }
+	#endif
+	#ifdef CORE_INT10_PIN
+	static ENCODER_ISR_ATTR void isr10(void) { Decoder::update(interruptArgs[10]); }
+	#endif
+	#ifdef CORE_INT11_PIN
+	static ENCODER_ISR_ATTR void isr11(void) { Decoder::update(interruptArgs[11]); }
+	#endif
+	#ifdef CORE_INT12_PIN
+	static ENCODER_ISR_ATTR void isr12(void) { Decoder::update(interruptArgs[12]); }
+	#endif
+	#ifdef CORE_INT13_PIN
+	static ENCODER_ISR_ATTR void isr13(void) { Decoder::update(interruptArgs[13]); }
+	#endif
+	#ifdef CORE_INT14_PIN
+	static ENCODER_ISR_ATTR void isr14(void) { Decoder::update(interruptArgs[14]); }
+	#endif
+	#ifdef CORE_INT15_PIN
+	static ENCODER_ISR_ATTR void isr15(void) { Decoder::update(interruptArgs[15]); }
+	#endif
+	#ifdef CORE_INT16_PIN
+	static ENCODER_ISR_ATTR void isr16(void) { Decoder::update(interruptArgs[16]); }
+	#endif
+	#ifdef CORE_INT17_PIN
+	static ENCODER_ISR_ATTR void isr17(void) { Decoder::update(interruptArgs[17]); }
+	#endif
+	#ifdef CORE_INT18_PIN
+	static ENCODER_ISR_ATTR void isr18(void) { Decoder::update(interruptArgs[18]); }
+	#endif
+	#ifdef CORE_INT19_PIN
+	static ENCODER_ISR_ATTR void isr19(void) { Decoder::update(interruptArgs[19]); }
+	#endif
+	#ifdef CORE_INT20_PIN
+	static ENCODER_ISR_ATTR void isr20(void) { Decoder::update(interruptArgs[20]); }
+	#endif
+	#ifdef CORE_INT21_PIN
+	static ENCODER_ISR_ATTR void isr21(void) { Decoder::update(interruptArgs[21]); }
+	#endif
+	#ifdef CORE_INT22_PIN
+	static ENCODER_ISR_ATTR void isr22(void) { Decoder::update(interruptArgs[22]); }
+	#endif
+	#ifdef CORE_INT23_PIN
+	static ENCODER_ISR_ATTR void isr23(void) { Decoder::update(interruptArgs[23]); }
+	#endif
+	#ifdef CORE_INT24_PIN
+	static ENCODER_ISR_ATTR void isr24(void) { Decoder::update(interruptArgs[24]); }
+	#endif
+	#ifdef CORE_INT25_PIN
+	static ENCODER_ISR_ATTR void isr25(void) { Decoder::update(interruptArgs[25]); }
+	#endif
+	#ifdef CORE_INT26_PIN
+	static ENCODER_ISR_ATTR void isr26(void) { Decoder::update(interruptArgs[26]); }
+	#endif
+	#ifdef CORE_INT27_PIN
+	static ENCODER_ISR_ATTR void isr27(void) { Decoder::update(interruptArgs[27]); }
+	#endif
+	#ifdef CORE_INT28_PIN
+	static ENCODER_ISR_ATTR void isr28(void) { Decoder::update(interruptArgs[28]); }
+	#endif
+	#ifdef CORE_INT29_PIN
+	static ENCODER_ISR_ATTR void isr29(void) { Decoder::update(interruptArgs[29]); }
+	#endif
+	#ifdef CORE_INT30_PIN
+	static ENCODER_ISR_ATTR void isr30(void) { Decoder::update(interruptArgs[30]); }
+	#endif
+	#ifdef CORE_INT31_PIN
+	static ENCODER_ISR_ATTR void isr31(void) { Decoder::update(interruptArgs[31]); }
+	#endif
+	#ifdef CORE_INT32_PIN
+	static ENCODER_ISR_ATTR void isr32(void) { Decoder::update(interruptArgs[32]); }
+	#endif
+	#ifdef CORE_INT33_PIN
+	static ENCODER_ISR_ATTR void isr33(void) { Decoder::update(interruptArgs[33]); }
+	#endif
+	#ifdef CORE_INT34_PIN
+	static ENCODER_ISR_ATTR void isr34(void) { Decoder::update(interruptArgs[34]); }
+	#endif
+	#ifdef CORE_INT35_PIN
+	static ENCODER_ISR_ATTR void isr35(void) { Decoder::update(interruptArgs[35]); }
+	#endif
+	#ifdef CORE_INT36_PIN
+	static ENCODER_ISR_ATTR void isr36(void) { Decoder::update(interruptArgs[36]); }
+	#endif
+	#ifdef CORE_INT37_PIN
+	static ENCODER_ISR_ATTR void isr37(void) { Decoder::update(interruptArgs[37]); }
+	#endif
+	#ifdef CORE_INT38_PIN
+	static ENCODER_ISR_ATTR void isr38(void) { Decoder::update(interruptArgs[38]); }
+	#endif
+	#ifdef CORE_INT39_PIN
+	static ENCODER_ISR_ATTR void isr39(void) { Decoder::update(interruptArgs[39]); }
+	#endif
+	#ifdef CORE_INT40_PIN
+	static ENCODER_ISR_ATTR void isr40(void) { Decoder::update(interruptArgs[40]); }
+	#endif
+	#ifdef CORE_INT41_PIN
+	static ENCODER_ISR_ATTR void isr41(void) { Decoder::update(interruptArgs[41]); }
+	#endif
+	#ifdef CORE_INT42_PIN
+	static ENCODER_ISR_ATTR void isr42(void) { Decoder::update(interruptArgs[42]); }
+	#endif
+	#ifdef CORE_INT43_PIN
+	static ENCODER_ISR_ATTR void isr43(void) { Decoder::update(interruptArgs[43]); }
+	#endif
+	#ifdef CORE_INT44_PIN
+	static ENCODER_ISR_ATTR void isr44(void) { Decoder::update(interruptArgs[44]); }
+	#endif
+	#ifdef CORE_INT45_PIN
+	static ENCODER_ISR_ATTR void isr45(void) { Decoder::update(interruptArgs[45]); }
+	#endif
+	#ifdef CORE_INT46_PIN
+	static ENCODER_ISR_ATTR void isr46(void) { Decoder::update(interruptArgs[46]); }
+	#endif
+	#ifdef CORE_INT47_PIN
+	static ENCODER_ISR_ATTR void isr47(void) { Decoder::update(interruptArgs[47]); }
+	#endif
+	#ifdef CORE_INT48_PIN
+	static ENCODER_ISR_ATTR void isr48(void) { Decoder::update(interruptArgs[48]); }
+	#endif
+	#ifdef CORE_INT49_PIN
+	static ENCODER_ISR_ATTR void isr49(void) { Decoder::update(interruptArgs[49]); }
+	#endif
+	#ifdef CORE_INT50_PIN
+	static ENCODER_ISR_ATTR void isr50(void) { Decoder::update(interruptArgs[50]); }
+	#endif
+	#ifdef CORE_INT51_PIN
+	static ENCODER_ISR_ATTR void isr51(void) { Decoder::update(interruptArgs[51]); }
+	#endif
+	#ifdef CORE_INT52_PIN
+	static ENCODER_ISR_ATTR void isr52(void) { Decoder::update(interruptArgs[52]); }
+	#endif
+	#ifdef CORE_INT53_PIN
+	static ENCODER_ISR_ATTR void isr53(void) { Decoder::update(interruptArgs[53]); }
+	#endif
+	#ifdef CORE_INT54_PIN
+	static ENCODER_ISR_ATTR void isr54(void) { Decoder::update(interruptArgs[54]); }
+	#endif
+	#ifdef CORE_INT55_PIN
+	static ENCODER_ISR_ATTR void isr55(void) { Decoder::update(interruptArgs[55]); }
+	#endif
+	#ifdef CORE_INT56_PIN
+	static ENCODER_ISR_ATTR void isr56(void) { Decoder::update(interruptArgs[56]); }
+	#endif
+	#ifdef CORE_INT57_PIN
+	static ENCODER_ISR_ATTR void isr57(void) { Decoder::update(interruptArgs[57]); }
+	#endif
+	#ifdef CORE_INT58_PIN
+	static ENCODER_ISR_ATTR void isr58(void) { Decoder::update(interruptArgs[58]); }
+	#endif
+	#ifdef CORE_INT59_PIN
+	static ENCODER_ISR_ATTR void isr59(void) { Decoder::update(interruptArgs[59]); }
+	#endif
+#endif
+};
+
+template <class State, class Decoder>
+State * EncoderDispatch<State, Decoder>::interruptArgs[ENCODER_ARGLIST_SIZE];
+
+#if defined(ENCODER_USE_INTERRUPTS) && defined(ENCODER_INTERRUPT_SLOTS)
+template <class State, class Decoder>
+uint8_t EncoderDispatch<State, Decoder>::interruptNumbers[ENCODER_INTERRUPT_SLOTS];
+template <class State, class Decoder>
+uint8_t EncoderDispatch<State, Decoder>::slotsUsed;
+#endif
+
+#endif
@@ -499,6 +499,12 @@
   #define CORE_INT75_PIN 75
   #define CORE_INT76_PIN 76
   
+
+// Linux, see linux_gpio.h.  Every line can deliver edge events, which
+// are dispatched by line number rather than through CORE_INTn_PIN.
+#elif defined(ENCODER_LINUX_GPIO)
+  #define CORE_NUM_INTERRUPT	ENCODER_LINUX_LINES
+
 #endif
 #endif
 
@@ -0,0 +1,115 @@
+// Minimal Arduino environment for Encoder on Linux, using GPIO edge events
+//
+// There is no attachInterrupt() on Linux.  Instead, the EncoderGpioEvents
+// class (EncoderLinuxGpio.h) reads edge events from the GPIO character
+// device and plays the part of the interrupt hardware: for each event it
+// stores the new level of the line, then calls the routine attached to
+// that line, which runs Encoder's normal update().  Pin numbers are line
+// offsets on the gpiochip.
+
+#ifndef linux_gpio_h_
+#define linux_gpio_h_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <mutex>
+
+#define ENCODER_LINUX_GPIO
+#define ENCODER_LINUX_LINES	256	// pins are uint8_t
+
+#ifndef INPUT
+#define INPUT		0x0
+#endif
+#ifndef INPUT_PULLUP
+#define INPUT_PULLUP	0x2
+#endif
+#ifndef HIGH
+#define HIGH		0x1
+#endif
+
+// Last known level of every line, written only by EncoderGpioEvents.
+// inline functions with static data, so all files share 1 copy.
+inline volatile uint8_t * encoder_linux_levels() {
+	static volatile uint8_t levels[ENCODER_LINUX_LINES];
+	return levels;
+}
+
+// Output levels, written by Encoder's setRetransmit() the way it writes
+// port registers on a board.  Nothing sends them to real lines.
+inline volatile uint8_t * encoder_linux_outputs() {
+	static volatile uint8_t outputs[ENCODER_LINUX_LINES];
+	return outputs;
+}
+
+// The "interrupt" routine for each line, called with the line number
+typedef void (*encoder_linux_isr_t)(uint8_t line);
+inline encoder_linux_isr_t * encoder_linux_vectors() {
+	static encoder_linux_isr_t vectors[ENCODER_LINUX_LINES];
+	return vectors;
+}
+
+// Event processing holds this lock, so noInterrupts() works as usual
+// when events are processed in another thread.  Recursive, because
+// compare callbacks run while it is held and may call read().
+inline std::recursive_mutex & encoder_linux_lock() {
+	static std::recursive_mutex lock;
+	return lock;
+}
+
+// Kernel timestamp of the event being processed, or 0 outside events
+inline uint64_t & encoder_linux_event_ns() {
+	static uint64_t ns;
+	return ns;
+}
+
+inline void noInterrupts() { encoder_linux_lock().lock(); }
+inline void interrupts() { encoder_linux_lock().unlock(); }
+
+// Inside event processing, micros() is the time the kernel saw the edge,
+// not when the event was read, so ENCODER_TRACK_MOTION timing stays
+// accurate even when many events are handled in 1 batch.
+inline uint32_t micros() {
+	uint64_t ns = encoder_linux_event_ns();
+	if (!ns) {
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		ns = (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+	return (uint32_t)(ns / 1000);
+}
+
+inline void delayMicroseconds(unsigned int us) {
+	struct timespec ts;
+	ts.tv_sec = us / 1000000;
+	ts.tv_nsec = (long)(us % 1000000) * 1000;
+	nanosleep(&ts, NULL);
+}
+
+inline void delay(unsigned long ms) {
+	struct timespec ts;
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (long)(ms % 1000) * 1000000;
+	nanosleep(&ts, NULL);
+}
+
+// Bias (pullup) and edge detection are configured when the lines are
+// requested from the kernel, so these do nothing.
+inline void pinMode(uint8_t pin, uint8_t mode) { }
+inline void digitalWrite(uint8_t pin, uint8_t value) { }
+
+// Enough of Arduino's Print for EncoderTelemetry, which only writes
+// bytes.  Derive from it to send them to a file, socket or serial port.
+class Print
+{
+public:
+	virtual ~Print() { }
+	virtual size_t write(uint8_t b) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size) {
+		size_t n = 0;
+		while (size--) n += write(*buffer++);
+		return n;
+	}
+};
+
+#endif